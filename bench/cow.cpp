@@ -0,0 +1,149 @@
+// Readers and writers of shared copy-on-write cells. COWPrimitive::get() and
+// reset() only forward to COWCell, which is measured directly, since
+// primitive needs an engine. BM_COWReadWrite writers run updates inline, so
+// that cost of allocation and publication is accounted to them, not to a
+// pool. BM_COWReset schedules updates on a thread pool instead, as reset()
+// does, while a reader keeps calling get() on the same cells.
+
+#include "imvk/base/COW.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Payload {
+  std::array<unsigned, 16> data;
+};
+
+// Stands for future of already initialized object.
+struct ReadyFuture {
+  void get() const {}
+};
+
+constexpr size_t cellCount = 1024u;
+
+std::vector<std::shared_ptr<imvk::COWCell<Payload>>> cells;
+
+void setupCells(const benchmark::State &) {
+  cells.clear();
+  for (size_t i = 0; i < cellCount; ++i) {
+    cells.push_back(std::make_shared<imvk::COWCell<Payload>>());
+    cells.back()->exchange(std::make_shared<Payload>());
+  }
+}
+
+void teardownCells(const benchmark::State &) { cells.clear(); }
+
+std::unique_ptr<imvk::ThreadPool> pool;
+std::atomic<bool> stopReader;
+std::thread reader;
+
+void setupPool(const benchmark::State &state) {
+  setupCells(state);
+  pool = std::make_unique<imvk::ThreadPool>(state.range(0));
+  stopReader = false;
+  reader = std::thread{[]() {
+    size_t i = 0;
+    while (!stopReader.load(std::memory_order_relaxed))
+      benchmark::DoNotOptimize(cells[i++ % cellCount]->get());
+  }};
+}
+
+void teardownPool(const benchmark::State &state) {
+  stopReader = true;
+  reader.join();
+  pool.reset();
+  teardownCells(state);
+}
+
+// First range(1) threads write, remaining range(0) threads read.
+void BM_COWReadWrite(benchmark::State &state) {
+  auto writer = state.thread_index() < state.range(1);
+  imvk::InlineExecutor executor;
+  size_t i = state.thread_index();
+  uint64_t operations = 0u;
+  for (auto _ : state) {
+    auto &cell = cells[i++ % cellCount];
+    if (writer) {
+      imvk::COWCell<Payload>::update(cell, executor, [i]() {
+        auto payload = std::make_shared<Payload>();
+        payload->data.fill(static_cast<unsigned>(i));
+        return std::pair{std::move(payload), ReadyFuture{}};
+      });
+    } else {
+      auto payload = cell->get();
+      benchmark::DoNotOptimize(payload->data[0]);
+    }
+    ++operations;
+  }
+  // Counters of threads are summed.
+  state.counters["reads"] = benchmark::Counter(
+      writer ? 0.0 : operations, benchmark::Counter::kIsRate);
+  state.counters["writes"] = benchmark::Counter(
+      writer ? operations : 0.0, benchmark::Counter::kIsRate);
+}
+
+// Every thread posts updates to a pool of range(0) workers and waits for them
+// in groups, so throughput of the pool is measured rather than latency of a
+// single update.
+void BM_COWReset(benchmark::State &state) {
+  constexpr size_t group = 256u;
+  std::vector<imvk::Completion> completions;
+  completions.reserve(group);
+  size_t i = state.thread_index();
+  for (auto _ : state) {
+    completions.push_back(imvk::COWCell<Payload>::update(
+        cells[i++ % cellCount], *pool, [i]() {
+          auto payload = std::make_shared<Payload>();
+          payload->data.fill(static_cast<unsigned>(i));
+          return std::pair{std::move(payload), ReadyFuture{}};
+        }));
+    if (completions.size() == group) {
+      for (auto &completion : completions)
+        completion.get();
+      completions.clear();
+    }
+  }
+  for (auto &completion : completions)
+    completion.get();
+  state.SetItemsProcessed(state.iterations());
+}
+
+const auto registered = []() {
+  for (int readers : {0, 1, 2, 4, 8})
+    for (int writers : {0, 1, 2, 4}) {
+      if (!readers && !writers)
+        continue;
+      benchmark::RegisterBenchmark("BM_COWReadWrite", BM_COWReadWrite)
+          ->Args({readers, writers})
+          ->ArgNames({"readers", "writers"})
+          ->Threads(readers + writers)
+          ->Setup(setupCells)
+          ->Teardown(teardownCells)
+          ->UseRealTime();
+    }
+  // Pool sizes are powers of 2, the last one is clamped to number of
+  // hardware threads. Pool is fed by as many threads as it has workers.
+  auto maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  for (unsigned threads = 1; threads <= maxThreads;
+       threads = threads == maxThreads ? maxThreads + 1u
+                                       : std::min(threads * 2u, maxThreads))
+    benchmark::RegisterBenchmark("BM_COWReset", BM_COWReset)
+        ->Arg(threads)
+        ->ArgName("workers")
+        ->Threads(threads)
+        ->Setup(setupPool)
+        ->Teardown(teardownPool)
+        ->UseRealTime();
+  return true;
+}();
+
+} // namespace
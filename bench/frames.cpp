@@ -0,0 +1,373 @@
+// Drives GraphicsEngine::run() in headless mode with a synthetic workload
+// for a fixed number of frames and reports distribution of per-frame host
+// timings as JSON. Nothing depends on a window or on timing of a display, so
+// results are comparable between runs, library versions and machines.
+//
+// Software rasterizers make numbers independent of GPU as well - select one
+// with the loader, e.g. for lavapipe:
+//   VK_DRIVER_FILES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json
+//
+// Each frame:
+//   - uploads specified amount of data to device local buffer with copy
+//     engine and makes the frame wait for it,
+//   - resets specified fraction of copy-on-write buffer primitives,
+//   - records draws. Draw is modelled by host work engine does for it: use
+//     of a primitive, per-draw constants in transient memory and a single
+//     transfer command, so no shaders are needed.
+//
+// Usage: imvk_bench_frames [--frames=N] [--warmup=N] [--draws=N]
+//                          [--primitives=N] [--churn=F] [--fif=N]
+//                          [--upload-mb=F] [--out=PATH]
+
+#include "imvk/base/Context.hpp"
+#include "imvk/base/ContextImpl.hpp"
+#include "imvk/base/Primitive.hpp"
+#include "imvk/base/ResourceAllocators.hpp"
+#include "imvk/copy/Engine.hpp"
+#include "imvk/graphics/Engine.hpp"
+
+#include "vkw/Device.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+  unsigned frames = 1000u;
+  unsigned warmup = 100u;
+  unsigned draws = 1000u;
+  unsigned primitives = 1000u;
+  /// Fraction of primitives reset every frame.
+  double churn = 0.01;
+  unsigned framesInFlight = 2u;
+  double uploadMB = 1.0;
+  std::string out;
+};
+
+template <typename T> T parseValue(std::string_view key, std::string_view str) {
+  T ret{};
+  auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), ret);
+  if (error != std::errc{} || end != str.data() + str.size())
+    throw std::runtime_error("Invalid value of " + std::string(key) + ": " +
+                             std::string(str));
+  return ret;
+}
+
+Config parseArgs(int argc, char **argv) {
+  Config ret;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto eq = arg.find('=');
+    auto key = arg.substr(0, eq);
+    auto value = eq == arg.npos ? std::string_view{} : arg.substr(eq + 1u);
+    if (key == "--frames")
+      ret.frames = parseValue<unsigned>(key, value);
+    else if (key == "--warmup")
+      ret.warmup = parseValue<unsigned>(key, value);
+    else if (key == "--draws")
+      ret.draws = parseValue<unsigned>(key, value);
+    else if (key == "--primitives")
+      ret.primitives = parseValue<unsigned>(key, value);
+    else if (key == "--churn")
+      ret.churn = parseValue<double>(key, value);
+    else if (key == "--fif")
+      ret.framesInFlight = parseValue<unsigned>(key, value);
+    else if (key == "--upload-mb")
+      ret.uploadMB = parseValue<double>(key, value);
+    else if (key == "--out")
+      ret.out = value;
+    else
+      throw std::runtime_error("Unknown argument " + std::string(arg));
+  }
+  if (!ret.frames || !ret.framesInFlight)
+    throw std::runtime_error("Frames and frames in flight must be non-zero");
+  return ret;
+}
+
+// Benchmark compiles no pipelines.
+class NullShaderFactory final : public imvk::ShaderFactory {
+public:
+  std::shared_ptr<vkw::SPIRVModule> getModule(std::string_view name) override {
+    throw std::runtime_error("No shaders available in benchmark: " +
+                             std::string(name));
+  }
+};
+
+// Instance and device without any surface support.
+class HeadlessDevice final {
+public:
+  HeadlessDevice()
+      : m_instance(m_vkLib,
+                   [&]() {
+                     if (m_vkLib.instanceAPIVersion() <
+                         vkw::ApiVersion{1, 2, 0})
+                       throw std::runtime_error(
+                           "Unsupported vulkan version. Required minimum: 1.2");
+                     vkw::InstanceCreateInfo ICI;
+                     ICI.apiVersion = vkw::ApiVersion{1, 2, 0};
+                     return ICI;
+                   }()),
+        m_device(m_instance, [&]() {
+          for (auto &&dev : m_instance.enumerateAvailableDevices()) {
+            if (dev->supportedApiVersion() < vkw::ApiVersion{1, 2, 0})
+              continue;
+            if (!dev->featureSupported(vkw::feature::timelineSemaphore()))
+              continue;
+            dev->enableFeature(vkw::feature::timelineSemaphore());
+            auto neededQueue =
+                std::ranges::find_if(dev->queueFamilies(), [&](auto &fam) {
+                  return fam.graphics() && fam.transfer() && fam.compute();
+                });
+            if (neededQueue == dev->queueFamilies().end())
+              continue;
+            neededQueue->requestQueue();
+            return std::move(*dev);
+          }
+          throw std::runtime_error("No suitable physical devices");
+        }()) {}
+
+  auto &get() { return m_device; }
+
+private:
+  vkw::Library m_vkLib;
+  vkw::Instance m_instance;
+  vkw::Device m_device;
+};
+
+using BufferPrimitive =
+    imvk::COWPrimitive<imvk::Buffer, imvk::BufferCOWAllocator>;
+
+// Contents of primitives. Must outlive all resets.
+constexpr std::array<std::byte, 256u> primitiveData{};
+
+// Number of distinct words draws write to.
+constexpr VkDeviceSize drawSlots = 1024u;
+
+struct DrawConstants {
+  std::array<float, 16> transform;
+  std::array<float, 4> color;
+  unsigned index;
+};
+
+class Workload final {
+public:
+  Workload(const Config &config, imvk::GraphicsEngine &graphics,
+           imvk::CopyEngine &copy)
+      : m_config(config), m_graphics(graphics), m_copy(copy),
+        m_families{graphics.queueFamilyIndex(), copy.queueFamilyIndex()},
+        m_drawTarget(graphics.context().deviceAllocator(),
+                     m_bufferCI(drawSlots * sizeof(uint32_t)),
+                     imvk::MemoryUsage::device),
+        m_uploadData(static_cast<size_t>(config.uploadMB * 1024.0 * 1024.0),
+                     std::byte{0x5a}) {
+    if (!m_uploadData.empty())
+      m_uploadTarget.emplace(graphics.context().deviceAllocator(),
+                             m_bufferCI(m_uploadData.size()),
+                             imvk::MemoryUsage::device);
+    m_primitives.reserve(config.primitives);
+    for (unsigned i = 0; i < config.primitives; ++i)
+      m_primitives.emplace_back(graphics, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    for (auto &primitive : m_primitives)
+      m_resets.push_back(primitive.reset(std::span{primitiveData}));
+    waitResets();
+  }
+
+  Workload(const Workload &) = delete;
+  Workload &operator=(const Workload &) = delete;
+
+  void record(const imvk::Frame &frame) {
+    if (m_uploadTarget) {
+      m_copy.upload(m_uploadTarget->handle(), 0u, m_uploadData);
+      m_graphics.waitFor(m_copy.flush(), VK_PIPELINE_STAGE_TRANSFER_BIT);
+    }
+
+    // Fractional churn accumulates, so that low rates are still exercised.
+    m_churnDebt += m_config.churn * m_primitives.size();
+    for (; m_churnDebt >= 1.0; m_churnDebt -= 1.0) {
+      m_resets.at(m_nextReset) =
+          m_primitives.at(m_nextReset).reset(std::span{primitiveData});
+      m_nextReset = (m_nextReset + 1u) % m_primitives.size();
+    }
+
+    auto &device = m_graphics.context().device();
+    auto &commands = frame.commands();
+    for (unsigned i = 0; i < m_config.draws; ++i) {
+      if (!m_primitives.empty())
+        if (auto handle = m_primitives[i % m_primitives.size()].get(frame))
+          frame.usePrimitive(handle);
+      frame.transientAllocator().push(DrawConstants{.index = i});
+      device.core<1, 0>().vkCmdFillBuffer(commands, m_drawTarget.handle(),
+                                          (i % drawSlots) * sizeof(uint32_t),
+                                          sizeof(uint32_t), i);
+    }
+  }
+
+  /// @brief Waits for resets of primitives scheduled so far.
+  void waitResets() {
+    for (auto &reset : m_resets)
+      if (reset.valid())
+        reset.get();
+  }
+
+  ~Workload() { waitResets(); }
+
+private:
+  VkBufferCreateInfo m_bufferCI(VkDeviceSize size) const {
+    VkBufferCreateInfo CI{};
+    CI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    CI.size = size;
+    CI.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    CI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // Written by both copy and graphics queues, which may be of different
+    // families.
+    if (m_families[0] != m_families[1]) {
+      CI.sharingMode = VK_SHARING_MODE_CONCURRENT;
+      CI.queueFamilyIndexCount = m_families.size();
+      CI.pQueueFamilyIndices = m_families.data();
+    }
+    return CI;
+  }
+
+  const Config &m_config;
+  imvk::GraphicsEngine &m_graphics;
+  imvk::CopyEngine &m_copy;
+  std::array<uint32_t, 2> m_families;
+  imvk::Buffer m_drawTarget;
+  std::vector<std::byte> m_uploadData;
+  std::optional<imvk::Buffer> m_uploadTarget;
+  std::vector<BufferPrimitive> m_primitives;
+  std::vector<imvk::Completion> m_resets;
+  double m_churnDebt = 0.0;
+  size_t m_nextReset = 0u;
+};
+
+struct Samples {
+  std::vector<double> frameTime;
+  std::vector<double> recordTime;
+  std::vector<double> fenceWait;
+  std::vector<double> submits;
+};
+
+double milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void writeDistribution(std::ostream &out, std::string_view name,
+                       std::vector<double> values) {
+  std::ranges::sort(values);
+  // Nearest rank.
+  auto percentile = [&](double p) {
+    auto rank = static_cast<size_t>(std::ceil(p * values.size()));
+    return values.at(std::clamp<size_t>(rank, 1u, values.size()) - 1u);
+  };
+  auto mean =
+      std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  out << "  \"" << name << "\": {\"mean\": " << mean
+      << ", \"p50\": " << percentile(0.5) << ", \"p99\": " << percentile(0.99)
+      << ", \"max\": " << values.back() << "}";
+}
+
+void writeReport(std::ostream &out, const Config &config,
+                 const Samples &samples, Clock::duration total) {
+  out.precision(4);
+  out.setf(std::ios::fixed, std::ios::floatfield);
+  out << "{\n"
+      << "  \"config\": {\"frames\": " << config.frames
+      << ", \"warmup\": " << config.warmup << ", \"draws\": " << config.draws
+      << ", \"primitives\": " << config.primitives
+      << ", \"churn\": " << config.churn
+      << ", \"framesInFlight\": " << config.framesInFlight
+      << ", \"uploadMB\": " << config.uploadMB << "},\n"
+      << "  \"unit\": \"ms\",\n"
+      << "  \"fps\": "
+      << config.frames / std::chrono::duration<double>(total).count()
+      << ",\n";
+  writeDistribution(out, "frameTime", samples.frameTime);
+  out << ",\n";
+  writeDistribution(out, "recordTime", samples.recordTime);
+  out << ",\n";
+  writeDistribution(out, "fenceWait", samples.fenceWait);
+  out << ",\n";
+  writeDistribution(out, "submitsPerFrame", samples.submits);
+  out << "\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) try {
+  auto config = parseArgs(argc, argv);
+
+  HeadlessDevice device;
+  NullShaderFactory shaderFactory;
+  imvk::Context context{imvk::ContextCreateInfo{
+      .device = device.get(), .shaderFactory = shaderFactory}};
+
+  auto uploadBytes =
+      static_cast<VkDeviceSize>(config.uploadMB * 1024.0 * 1024.0);
+  auto copyEngine = context.createCopyEngine(
+      imvk::CopyEngineCreateInfo{.stagingBufferSize = uploadBytes * 2u});
+  auto graphicsEngine = context.createGraphicsEngine(
+      imvk::GraphicsEngineCreateInfo{
+          .swapchainFactory = nullptr,
+          .maxFramesInFlight = config.framesInFlight,
+          .transientBufferSize = (config.draws + 1u) * 256u,
+          .pacingMode = imvk::FramePacingMode::throughput});
+
+  Workload workload{config, *graphicsEngine, *copyEngine};
+
+  Samples samples;
+  Clock::duration recordTime{}, fenceWait{};
+  Clock::time_point frameStart, measureStart;
+  uint64_t submitCalls = 0u;
+  unsigned iteration = 0u;
+
+  graphicsEngine->run(
+      [&](const imvk::SwapFrame &frame) {
+        fenceWait = graphicsEngine->pacingStatistics().lastFenceWaitTime;
+        auto start = Clock::now();
+        workload.record(frame.frame());
+        recordTime = Clock::now() - start;
+      },
+      [&]() {
+        // Frame of previous iteration is handed over to the queue by now.
+        auto now = Clock::now();
+        auto submits = context.submitStatistics().submitCalls;
+        if (iteration > config.warmup) {
+          samples.frameTime.push_back(milliseconds(now - frameStart));
+          samples.recordTime.push_back(milliseconds(recordTime));
+          samples.fenceWait.push_back(milliseconds(fenceWait));
+          samples.submits.push_back(submits - submitCalls);
+        } else if (iteration == config.warmup)
+          measureStart = now;
+        frameStart = now;
+        submitCalls = submits;
+        return iteration++ < config.warmup + config.frames;
+      });
+  auto total = frameStart - measureStart;
+
+  if (config.out.empty())
+    writeReport(std::cout, config, samples, total);
+  else {
+    std::ofstream out{config.out};
+    if (!out)
+      throw std::runtime_error("Failed to open " + config.out);
+    writeReport(out, config, samples, total);
+  }
+  return 0;
+} catch (std::exception &e) {
+  std::cerr << "ERROR: " << e.what() << std::endl;
+  return 1;
+}
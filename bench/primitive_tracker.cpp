@@ -0,0 +1,80 @@
+// Per-frame primitive bookkeeping: Frame::usePrimitive() and the release of
+// unused primitives in Frame::begin(). Both only forward to PrimitiveTracker,
+// which is measured directly, since Frame needs a device.
+
+#include "imvk/base/Primitive.hpp"
+#include "imvk/base/PrimitiveTracker.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Trackers are reserved up front for all primitives, so that growth of their
+// tables is not measured (see tables.cpp).
+std::vector<std::shared_ptr<imvk::PrimitiveHandleBase>>
+makePrimitives(size_t count) {
+  std::vector<std::shared_ptr<imvk::PrimitiveHandleBase>> ret;
+  ret.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    ret.push_back(std::make_shared<imvk::PrimitiveHandleBase>(1u));
+  return ret;
+}
+
+// Every primitive is used by every frame - steady state of static scene.
+void BM_TrackerSteady(benchmark::State &state) {
+  auto primitives = makePrimitives(state.range(0));
+  imvk::PrimitiveTracker tracker{0u, primitives.size()};
+  for (auto _ : state) {
+    tracker.beginEpoch();
+    for (auto &primitive : primitives)
+      tracker.use(primitive);
+  }
+  state.SetItemsProcessed(state.iterations() * primitives.size());
+}
+
+// Each frame uses a different tenth of primitives, so previous tenth is
+// released by the next beginEpoch().
+void BM_TrackerTurnover(benchmark::State &state) {
+  auto primitives = makePrimitives(state.range(0));
+  auto slice = std::max<size_t>(primitives.size() / 10u, 1u);
+  imvk::PrimitiveTracker tracker{0u, primitives.size()};
+  size_t offset = 0u;
+  for (auto _ : state) {
+    tracker.beginEpoch();
+    for (size_t i = 0; i < slice; ++i)
+      tracker.use(primitives[(offset + i) % primitives.size()]);
+    offset += slice;
+  }
+  state.SetItemsProcessed(state.iterations() * slice);
+}
+
+// Only beginEpoch() with a large set of tracked primitives that are all
+// still in use - cost must not depend on tracked count. Every primitive is
+// used before each epoch, which is not timed.
+void BM_TrackerBeginEpoch(benchmark::State &state) {
+  auto primitives = makePrimitives(state.range(0));
+  imvk::PrimitiveTracker tracker{0u, primitives.size()};
+  for (auto _ : state) {
+    for (auto &primitive : primitives)
+      tracker.use(primitive);
+    auto start = std::chrono::steady_clock::now();
+    tracker.beginEpoch();
+    state.SetIterationTime(std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_TrackerSteady)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_TrackerTurnover)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_TrackerBeginEpoch)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->UseManualTime();
@@ -0,0 +1,76 @@
+// Contention of engines sharing a queue. Queue only binds SubmitBatcher to a
+// device queue, so the batcher is measured directly with a sink that issues
+// nothing: lock mode (Queue::acquire() and Queue::submit() under the lock)
+// and submitter thread mode. Each operation hands over a batch of the same
+// size as a small frame submission.
+
+#include "imvk/base/SubmitBatcher.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace {
+
+constexpr size_t batchSize = 4u;
+
+std::unique_ptr<imvk::SubmitBatcher> batcher;
+
+std::vector<imvk::SubmitBatch> makeBatches() {
+  return std::vector<imvk::SubmitBatch>(batchSize);
+}
+
+void startBatcher(bool submitThread) {
+  batcher = std::make_unique<imvk::SubmitBatcher>(
+      [](std::span<imvk::SubmitBatch> batches, VkFence) {
+        benchmark::DoNotOptimize(batches.data());
+      },
+      true, std::chrono::microseconds{0});
+  if (submitThread)
+    batcher->introduceSubmitThread();
+}
+
+void startLocked(const benchmark::State &) { startBatcher(false); }
+
+void startSubmitter(const benchmark::State &) { startBatcher(true); }
+
+void stopBatcher(const benchmark::State &) { batcher.reset(); }
+
+// Every thread submits in lock mode, as engines do with Queue::submit().
+// Every 16th operation is Queue::acquire() instead, which flushes.
+void BM_QueueAcquire(benchmark::State &state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    if (++i % 16u == 0u) {
+      auto lock = batcher->acquire();
+      benchmark::DoNotOptimize(lock.owns_lock());
+    } else
+      batcher->submit(makeBatches());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Every thread pushes submission into submitter's ring and returns, as
+// Queue::submit() does in submitter thread mode. Full ring blocks producer,
+// so sustained rate is bounded by the submitter thread.
+void BM_QueueSubmitThread(benchmark::State &state) {
+  for (auto _ : state)
+    batcher->submit(makeBatches());
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_QueueAcquire)
+    ->ThreadRange(1, 8)
+    ->Setup(startLocked)
+    ->Teardown(stopBatcher)
+    ->UseRealTime();
+BENCHMARK(BM_QueueSubmitThread)
+    ->ThreadRange(1, 8)
+    ->Setup(startSubmitter)
+    ->Teardown(stopBatcher)
+    ->UseRealTime();
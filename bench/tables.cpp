@@ -0,0 +1,86 @@
+// LinearTable and DenseLinearTable: filling, steady churn and iteration.
+
+#include "imvk/base/Utils.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Roughly the size of a tracker entry.
+struct Payload {
+  std::array<uint64_t, 4> data;
+};
+
+// Same as PrimitiveTracker default. Smallest step tables grow by.
+constexpr size_t reserveChunkSize = 100u;
+
+template <typename Table> void BM_TableFill(benchmark::State &state) {
+  auto count = static_cast<size_t>(state.range(0));
+  std::vector<unsigned> ids(count);
+  for (auto _ : state) {
+    Table table{reserveChunkSize};
+    for (size_t i = 0; i < count; ++i)
+      ids[i] = std::get<0>(table.emplace());
+    for (auto id : ids)
+      table.erase(id);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * count * 2u);
+}
+
+// Table of fixed size, entries are erased in random order and refilled.
+// Table is reserved up front, as only steady state is measured.
+template <typename Table> void BM_TableChurn(benchmark::State &state) {
+  auto count = static_cast<size_t>(state.range(0));
+  Table table{count};
+  std::vector<unsigned> ids;
+  for (size_t i = 0; i < count; ++i)
+    ids.push_back(std::get<0>(table.emplace()));
+
+  std::mt19937 random{42u};
+  std::uniform_int_distribution<size_t> pick{0u, count - 1u};
+  for (auto _ : state) {
+    auto &id = ids[pick(random)];
+    table.erase(id);
+    id = std::get<0>(table.emplace());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Half of entries erased at random, so sparse table has holes to skip.
+template <typename Table> void BM_TableIterate(benchmark::State &state) {
+  auto count = static_cast<size_t>(state.range(0));
+  Table table{count};
+  std::vector<unsigned> ids;
+  for (size_t i = 0; i < count; ++i)
+    ids.push_back(std::get<0>(table.emplace()));
+  std::mt19937 random{42u};
+  std::shuffle(ids.begin(), ids.end(), random);
+  for (size_t i = 0; i < count / 2u; ++i)
+    table.erase(ids[i]);
+
+  for (auto _ : state) {
+    uint64_t sum = 0u;
+    for (auto &&[id, payload] : table.items())
+      sum += id + payload.data[0];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * (count - count / 2u));
+}
+
+using Sparse = imvk::LinearTable<unsigned, Payload>;
+using Dense = imvk::DenseLinearTable<unsigned, Payload>;
+
+} // namespace
+
+BENCHMARK(BM_TableFill<Sparse>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_TableFill<Dense>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_TableChurn<Sparse>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_TableChurn<Dense>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_TableIterate<Sparse>)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_TableIterate<Dense>)->RangeMultiplier(10)->Range(1000, 1000000);
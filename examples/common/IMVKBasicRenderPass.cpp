@@ -1,13 +1,18 @@
 #include "IMVKBasicRenderPass.hpp"
 #include <array>
+#include <utility>
 
 namespace imvk::examples {
 
+// Example renders to a window, so engine is never headless.
 BasicRenderPass::BasicRenderPass(imvk::GraphicsEngine &engine)
-    : m_engine(engine), m_currentSwapchain(&engine.swapchain()),
+    : m_engine(engine),
+      m_currentSwapchain(
+          &static_cast<const imvk::Swapchain &>(engine.swapchain())),
       m_pass(engine.context().device(), [&]() {
         std::vector<vkw::AttachmentDescription> attachments;
-        auto colorFormat = engine.swapchain().images().front().format();
+        auto colorFormat = engine.swapchain().format();
+        auto layout = engine.swapchain().layout();
 
         auto attachmentDescription =
             vkw::AttachmentDescription{0u,
@@ -17,8 +22,8 @@ BasicRenderPass::BasicRenderPass(imvk::GraphicsEngine &engine)
                                        VK_ATTACHMENT_STORE_OP_STORE,
                                        VK_ATTACHMENT_LOAD_OP_DONT_CARE,
                                        VK_ATTACHMENT_STORE_OP_DONT_CARE,
-                                       VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                                       VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
+                                       layout,
+                                       layout};
         attachments.push_back(attachmentDescription);
 
         auto subpassDescription = vkw::SubpassDescription{};
@@ -52,15 +57,19 @@ BasicRenderPass::BasicRenderPass(imvk::GraphicsEngine &engine)
       }()) {
   m_recreateFramebuffers();
   m_engine.addSwapchainCallback([this]() { m_clearFramebuffers(); },
-                                [this](const imvk::Swapchain &swapchain) {
-                                  m_currentSwapchain = &swapchain;
+                                [this](const imvk::SwapchainBase &swapchain) {
+                                  m_currentSwapchain =
+                                      &static_cast<const imvk::Swapchain &>(
+                                          swapchain);
                                   m_recreateFramebuffers();
                                 });
 }
 
 void BasicRenderPass::m_clearFramebuffers() {
-  m_framebuffers.clear();
-  m_swapImageViews.clear();
+  // Frames in flight may still use them. Framebuffers go first so that they
+  // are destroyed before views they reference.
+  m_engine.deferDestruction(std::exchange(m_framebuffers, {}));
+  m_engine.deferDestruction(std::exchange(m_swapImageViews, {}));
 }
 void BasicRenderPass::m_recreateFramebuffers() {
 
@@ -89,6 +98,8 @@ void BasicRenderPass::run(const SwapFrame &frame,
 
   VkClearValue clearValue{.color = {0.8, 0.5, 0.2, 0.0}};
 
+  imvk::GpuScope scope{frame.frame(), "BasicRenderPass"};
+
   commands.beginRenderPass(m_pass, fb, fb.getFullRenderArea(),
                            /*use secondary */ false,
                            std::span<const VkClearValue>{&clearValue, 1u});
@@ -71,6 +71,10 @@ Device::Device(const DeviceCreateInfo &CI)
           if (!dev->extensionSupported(vkw::ext::KHR_swapchain))
             continue;
           dev->enableExtension(vkw::ext::KHR_swapchain);
+          // imvk engines synchronize with each other via timeline semaphores.
+          if (!dev->featureSupported(vkw::feature::timelineSemaphore()))
+            continue;
+          dev->enableFeature(vkw::feature::timelineSemaphore());
           auto neededQueue =
               std::ranges::find_if(dev->queueFamilies(), [&](auto &fam) {
                 return fam.graphics() && fam.transfer() && fam.compute();
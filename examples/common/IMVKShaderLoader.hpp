@@ -10,7 +10,7 @@ struct ShaderLoaderCreateInfo {
 };
 
 // Just loads a shader from file in specified directory. Does not
-// cache them currently.
+// cache them - wrap it into imvk::CachingShaderFactory for that.
 class ShaderLoader final : public imvk::ShaderFactory {
 public:
   ShaderLoader(const ShaderLoaderCreateInfo &CI);
@@ -1,4 +1,6 @@
 #include "imvk/base/Context.hpp"
+#include "imvk/base/ShaderCache.hpp"
+#include "imvk/base/Trace.hpp"
 #include "imvk/graphics/Engine.hpp"
 
 #include "IMVKBasicRenderPass.hpp"
@@ -6,6 +8,7 @@
 #include "IMVKShaderLoader.hpp"
 #include "IMVKWindow.hpp"
 
+#include <fstream>
 #include <iostream>
 
 int main() try {
@@ -24,20 +27,31 @@ int main() try {
   imvk::examples::ShaderLoaderCreateInfo shaderLoaderCI{.shaderDirectory =
                                                             "assets/shaders"};
   imvk::examples::ShaderLoader shaderLoader{shaderLoaderCI};
+  // Loader reads file on every request, so put a cache in front of it.
+  imvk::CachingShaderFactory shaderCache{shaderLoader};
 
   // Create instance of imvk context.
   imvk::ContextCreateInfo imvkCCI{.device = imvkDevice.get(),
-                                  .shaderFactory = shaderLoader};
+                                  .shaderFactory = shaderCache,
+                                  .pipelineCachePath = "pipeline.cache"};
   imvk::Context imvkContext{imvkCCI};
 
   // Create graphics engine.
   imvk::GraphicsEngineCreateInfo geCI{.swapchainFactory = &window,
-                                      .maxFramesInFlight = 2};
+                                      .maxFramesInFlight = 3,
+                                      .pacingMode =
+                                          imvk::FramePacingMode::latency,
+                                      .gpuScopesPerFrame = 16};
   auto graphicsEngine = imvkContext.createGraphicsEngine(geCI);
 
   // Create basic render pass.
   auto renderPass = imvk::examples::BasicRenderPass{*graphicsEngine};
 
+#ifdef IMVK_ENABLE_TRACING
+  // Host spans are streamed to the file while application runs.
+  imvk::trace::startStreaming("cpu_trace.json");
+#endif
+
   // Main application loop.
   graphicsEngine->run(
       [&](auto &frame) {
@@ -50,6 +64,15 @@ int main() try {
         return !window.shouldClose();
       });
 
+#ifdef IMVK_ENABLE_TRACING
+  imvk::trace::stopStreaming();
+#endif
+
+  // Dump GPU timings of last frames, open it with chrome://tracing or
+  // Perfetto.
+  std::ofstream gpuTrace{"gpu_trace.json"};
+  graphicsEngine->gpuProfiler().writeChromeTrace(gpuTrace);
+
   return 0;
 } catch (std::runtime_error &e) {
   std::cerr << "RUNTIME ERROR: " << e.what() << std::endl;
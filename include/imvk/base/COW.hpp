@@ -0,0 +1,114 @@
+#pragma once
+#include "imvk/base/Executor.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+namespace imvk {
+
+/// @brief Initialization future that runs a continuation once it's ready, so
+/// that nobody has to wait for it. See CopyEngine's UploadFuture.
+template <typename F>
+concept ContinuableFuture = requires(const F &future) {
+  future.then(std::function<void()>{});
+  future.get();
+};
+
+template <typename Handle> class COWCell;
+
+/// @brief Job of COWCell::update. Job, captured allocate callable and
+/// completion state share single allocation. Publication chained to a
+/// ContinuableFuture is a std::function stored by the future, which
+/// allocates on it's own.
+template <typename Handle, typename Allocate>
+class COWUpdateJob final
+    : public Job,
+      public CompletionState,
+      public std::enable_shared_from_this<COWUpdateJob<Handle, Allocate>> {
+public:
+  COWUpdateJob(std::shared_ptr<COWCell<Handle>> cell, Allocate allocate)
+      : m_cell(std::move(cell)), m_allocate(std::move(allocate)) {}
+
+  void run() override {
+    try {
+      auto allocated = m_allocate();
+      using InitFuture = std::remove_cvref_t<decltype(allocated.second)>;
+      if constexpr (ContinuableFuture<InitFuture>) {
+        // Publication runs wherever initialization completes, executor's
+        // thread is released right away.
+        InitFuture initFuture = allocated.second;
+        initFuture.then([self = this->shared_from_this(),
+                         handle = std::move(allocated.first),
+                         initFuture]() mutable {
+          self->m_publish(std::move(handle), initFuture);
+        });
+      } else
+        m_publish(std::move(allocated.first), allocated.second);
+    } catch (...) {
+      complete(std::current_exception());
+    }
+  }
+
+private:
+  void m_publish(std::shared_ptr<Handle> handle, const auto &initFuture) {
+    try {
+      initFuture.get();
+      // Old object is released outside of exchange.
+      auto stale = m_cell->exchange(std::move(handle));
+      stale.reset();
+      complete();
+    } catch (...) {
+      complete(std::current_exception());
+    }
+  }
+
+  std::shared_ptr<COWCell<Handle>> m_cell;
+  Allocate m_allocate;
+};
+
+/// @brief Engine-independent core of copy-on-write primitive. Holds current
+/// object and replaces it with newly allocated ones. Object is published with
+/// atomic exchange. std::atomic<std::shared_ptr> is not lock-free in common
+/// standard libraries - reads and exchanges take a short internal lock held
+/// only for reference count update, never while old object is destroyed.
+/// @tparam Handle type of object.
+template <typename Handle> class COWCell {
+public:
+  std::shared_ptr<Handle> get() const {
+    return m_current.load(std::memory_order_acquire);
+  }
+
+  /// @brief Publishes new object. Returns previous one.
+  std::shared_ptr<Handle> exchange(std::shared_ptr<Handle> handle) {
+    return m_current.exchange(std::move(handle), std::memory_order_acq_rel);
+  }
+
+  /// @brief Schedules update of the cell on executor: allocation of new
+  /// object, wait for it's initialization and publication. Steps are chained
+  /// within single job, which is allocated together with it's completion
+  /// state and captured allocate callable. Objects allocate callable creates
+  /// and continuation registered on a ContinuableFuture are allocated
+  /// separately.
+  /// @param cell cell to update. Is kept alive until update completes.
+  /// @param executor executor to run update on.
+  /// @param allocate callable returning pair of new object and future of
+  /// it's initialization. If future is a ContinuableFuture - publication is
+  /// chained to it and runs where initialization completes. Otherwise
+  /// initialization is waited on executor's thread.
+  /// @return completion of publication.
+  static Completion update(std::shared_ptr<COWCell> cell, Executor &executor,
+                           auto &&allocate) {
+    auto job = std::make_shared<
+        COWUpdateJob<Handle, std::decay_t<decltype(allocate)>>>(
+        std::move(cell), std::forward<decltype(allocate)>(allocate));
+    executor.post(job);
+    return Completion{std::move(job)};
+  }
+
+private:
+  std::atomic<std::shared_ptr<Handle>> m_current;
+};
+
+} // namespace imvk
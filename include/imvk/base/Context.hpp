@@ -1,14 +1,23 @@
 #pragma once
+#include "imvk/base/DeviceAllocator.hpp"
+#include "imvk/base/Executor.hpp"
 #include "imvk/base/Shader.hpp"
+#include "imvk/base/Submit.hpp"
 #include "imvk/base/Swapchain.hpp"
+#include "imvk/base/Timeline.hpp"
 #include "vkw/Device.hpp"
 
+#include <chrono>
+#include <filesystem>
+
 namespace imvk {
 
 struct ContextCreateInfo {
   /// The device that this context will be using to do all jobs.
   /// There are some required extensions expected to be present:
   ///    VK_KHR_Swapchain
+  /// Required features:
+  ///    timelineSemaphore (core in Vulkan 1.2)
   /// Additional extensions may be passed that may improve capabilities
   /// of this context but are not required to run:
   ///    TBD
@@ -22,25 +31,89 @@ struct ContextCreateInfo {
   /// Shader factory is used to fetch shader modules using string as a key. User
   /// must provide their implementation of this interface.
   std::reference_wrapper<ShaderFactory> shaderFactory;
+
+  /// If set, queues shared by several engines are served by dedicated
+  /// submitter thread, to which engines push their submissions through
+  /// lock-free ring. Otherwise shared queues are guarded by a mutex.
+  bool threadedSubmission = false;
+
+  /// Submissions of engines sharing a queue are collected within this window
+  /// and issued with single vkQueueSubmit. Zero window still merges
+  /// submissions that are pushed while submitter thread is busy.
+  std::chrono::microseconds submitCoalescingWindow{0};
+
+  /// Path to a file pipeline cache is loaded from and stored to. Cache that
+  /// was produced by another device or driver is discarded. Pass empty path
+  /// to keep pipeline cache in memory only.
+  std::filesystem::path pipelineCachePath;
+
+  /// Size of device memory blocks resources are sub-allocated from. Larger
+  /// resources get dedicated allocations. Pass 0 for auto.
+  VkDeviceSize deviceMemoryBlockSize = 0u;
+
+  /// Executor background updates of primitives (see COWPrimitive::reset) are
+  /// run on. Must outlive context. Pass null to let context create it's own
+  /// thread pool.
+  Executor *executor = nullptr;
+};
+
+enum class FramePacingMode {
+  /// All frames in flight are used and frames are started as soon as
+  /// possible. Maximizes frame rate.
+  throughput,
+  /// Frames in flight and start of each frame are adjusted so that host
+  /// spends as little time as possible blocked on device. Input sampled
+  /// between frames gets to the screen sooner at the cost of some frame rate.
+  latency
 };
 
 struct GraphicsEngineCreateInfo {
   /// Swapchain factory is used to create and maintain internal swapchain. User
-  /// must provide their implementation of this interface. Pass null for no
-  /// swapchain. Without swapchain engine won't be able to perform present
-  /// operations.
+  /// must provide their implementation of this interface. Pass null for
+  /// headless mode - frames render to a ring of offscreen images (see
+  /// OffscreenSwapchain) and nothing is presented, so frame rate is bounded
+  /// by device only.
   SwapchainFactory *swapchainFactory;
 
   /// Number of frames in flight to allocate resources to. Pass 0 for auto.
   unsigned maxFramesInFlight;
+
+  /// Size in bytes of per-frame buffer transient data is allocated from (see
+  /// Frame::transientAllocator()). Pass 0 for auto.
+  VkDeviceSize transientBufferSize;
+
+  /// Policy engine paces frames with.
+  FramePacingMode pacingMode;
+
+  /// Upper bound of frames per second engine produces. Pass 0 for no limit.
+  float maxFrameRate;
+
+  /// Maximum number of GpuScope objects each frame may record. Scopes past
+  /// that are not measured. Pass 0 to disable GPU profiling.
+  unsigned gpuScopesPerFrame;
+
+  /// Extent of offscreen images in headless mode. Pass 0 for auto.
+  VkExtent2D offscreenExtent;
+
+  /// Format of offscreen images in headless mode. Pass VK_FORMAT_UNDEFINED
+  /// for auto.
+  VkFormat offscreenFormat;
 };
 
 struct ComputeEngineCreateInfo {
-  // TODO
+  /// Number of batches that may be executed on device simultaneously. Each
+  /// of them holds a separate command buffer. Pass 0 for auto.
+  unsigned maxBatchesInFlight;
 };
 
 struct CopyEngineCreateInfo {
-  // TODO
+  /// Size of persistently mapped staging ring buffer in bytes. Any single
+  /// image upload must fit in it. Pass 0 for auto.
+  VkDeviceSize stagingBufferSize;
+
+  /// Number of copy batches that may be executed on device simultaneously.
+  /// Pass 0 for auto.
+  unsigned maxBatchesInFlight;
 };
 
 class ContextImpl;
@@ -60,7 +133,12 @@ public:
   /// on a separate queue. If any 2 engines happen to operate on
   /// the same queue - their accesses to that queue are internally
   /// synchronized.
-  /// TODO: On-device inter queue synchronization is not supported yet.
+  ///
+  /// Engines synchronize with each other on device via sync points. Each
+  /// engine owns a timeline semaphore and every it's submission signals
+  /// a new point on it. Any engine may be told to wait for a point of
+  /// another engine with waitFor() - then it's next submission waits for
+  /// that point on device without host involvement.
   ///
   /// IMPORTANT: creating of engines must be synchronized, which means no
   /// engine that was created prior to creation of a new one must not execute
@@ -86,6 +164,17 @@ public:
   /// data streaming operations asynchronous to graphics pipeline operations.
   EngineHandle<CopyEngine> createCopyEngine(const CopyEngineCreateInfo &CI);
 
+  /// Returns statistics of merging engine submissions that share a queue.
+  SubmitStatistics submitStatistics() const;
+
+  /// Stores pipeline cache to the file specified by
+  /// ContextCreateInfo::pipelineCachePath. Cache is also stored upon context
+  /// destruction. May be called concurrently with engine operation.
+  void savePipelineCache();
+
+  /// Returns statistics of device memory allocated for resources.
+  DeviceAllocatorStatistics deviceAllocatorStatistics() const;
+
   virtual ~Context();
 
 private:
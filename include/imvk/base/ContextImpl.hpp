@@ -1,7 +1,10 @@
 #pragma once
 
 #include "imvk/base/Context.hpp"
+#include "imvk/base/DeviceAllocator.hpp"
+#include "imvk/base/PipelineCache.hpp"
 #include "imvk/base/Queue.hpp"
+#include "imvk/base/Timeline.hpp"
 
 #include <unordered_map>
 
@@ -18,32 +21,69 @@ class ContextImpl {
 public:
   auto &device() { return m_device; }
   auto &shaderFactory() { return m_shaderFactory; }
+  auto &pipelineCache() { return m_pipelineCache; }
+  /// @brief Returns allocator all resources created by engines take device
+  /// memory from.
+  auto &deviceAllocator() { return m_deviceAllocator; }
+  /// @brief Returns executor for background work of primitives.
+  Executor &executor() { return m_executor; }
   /// TODO: add queue management.
 
   /// @brief Hands over one queue that satisfy all required capabilities.
   /// This queue may be already acquired by another engine in which case
-  /// lock mechanism is introduces. Context tries to minimize amount of
+  /// lock mechanism or submitter thread is introduced, depending on
+  /// ContextCreateInfo::threadedSubmission. Context tries to minimize amount of
   /// shared queues by picking queue family that is just enough to satisfy
   /// required capabilities.
   /// IMPORTANT: calls to this procedure must be externally synchronized.
   Queue &allocateQueue(const QueueCapsInfo &queueInfo);
 
   /// @brief Upon destruction engine must 'free' it's queue which reduces number
-  /// of references to it. If it reaches 1 - lock is abolished, if it reaches 0
+  /// of references to it. If it reaches 1 - lock (or submitter thread) is
+  /// abolished, if it reaches 0
   /// - queue is freed and is ready to be reallocated again for new engines.
   /// IMPORTANT: calls to this procedure must be externally synchronized.
   void freeQueue(Queue &queue);
 
+  /// @brief Creates a timeline semaphore that is used by an engine to signal
+  /// it's sync points, or reuses one freed by a destroyed engine. Timelines
+  /// live as long as context does, so sync points remain valid even after
+  /// engine that produced them is destroyed. Engine must continue from
+  /// current value of reused timeline.
+  /// IMPORTANT: calls to this procedure must be externally synchronized.
+  TimelineSemaphore &allocateTimeline();
+
+  /// @brief Returns timeline to the context once engine is destroyed. All
+  /// work of the engine must be complete. Points engine has reserved but
+  /// never submitted are signaled from host, so they are reached too.
+  /// @param lastValue last value engine has reserved on the timeline.
+  /// IMPORTANT: calls to this procedure must be externally synchronized.
+  void freeTimeline(TimelineSemaphore &timeline, uint64_t lastValue);
+
+  /// @brief Returns submission batching statistics summed over all queues
+  /// that are currently allocated.
+  /// IMPORTANT: calls to this procedure must be externally synchronized with
+  /// queue allocation.
+  SubmitStatistics submitStatistics() const;
+
 private:
   ContextImpl(const ContextCreateInfo &CI);
 
   friend class Context;
   vkw::Device &m_device;
   ShaderFactory &m_shaderFactory;
+  bool m_threadedSubmission;
+  std::chrono::microseconds m_submitCoalescingWindow;
+  PipelineCache m_pipelineCache;
+  DeviceAllocator m_deviceAllocator;
+  std::unique_ptr<ThreadPool> m_threadPool;
+  Executor &m_executor;
 
   Queue &m_allocateQueue(unsigned queueFamilyIndex, unsigned queueIndex);
 
   std::unordered_map<Queue *, std::unique_ptr<Queue>> m_queueStorage;
+  std::vector<std::unique_ptr<TimelineSemaphore>> m_timelines;
+  std::vector<TimelineSemaphore *> m_freeTimelines;
   std::unordered_map<unsigned,
                      std::unordered_map<unsigned, std::pair<Queue *, unsigned>>>
       m_queueMap;
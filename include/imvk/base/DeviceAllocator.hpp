@@ -0,0 +1,173 @@
+#pragma once
+#include "imvk/base/TLSF.hpp"
+
+#include "vkw/Device.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace imvk {
+
+/// @brief Intended access pattern of allocated memory. Used to pick memory
+/// type.
+enum class MemoryUsage {
+  /// Accessed by device only. Filled with transfer commands.
+  device,
+  /// Written by host once, read by device. Host memory is preferred.
+  upload,
+  /// Frequently written by host, read by device. Device local host visible
+  /// memory is preferred.
+  dynamic,
+  /// Written by device, read by host. Host cached memory is preferred.
+  readback
+};
+
+class DeviceAllocator;
+
+class DeviceAllocation final {
+public:
+  /// @class DeviceAllocation
+  /// Range of device memory handed out by DeviceAllocator. Range is returned
+  /// to allocator upon destruction. Resource bound to it must be destroyed
+  /// before.
+
+  DeviceAllocation() = default;
+  DeviceAllocation(const DeviceAllocation &) = delete;
+  DeviceAllocation &operator=(const DeviceAllocation &) = delete;
+  DeviceAllocation(DeviceAllocation &&another) noexcept;
+  DeviceAllocation &operator=(DeviceAllocation &&another) noexcept;
+
+  explicit operator bool() const { return m_allocator; }
+
+  VkDeviceMemory memory() const { return m_memory; }
+  VkDeviceSize offset() const { return m_offset; }
+  VkDeviceSize size() const { return m_size; }
+  uint32_t memoryType() const { return m_memoryType; }
+  bool dedicated() const { return !m_block; }
+
+  /// @brief Returns pointer to the beginning of allocation or nullptr if
+  /// memory is not host visible. Host visible memory is persistently mapped.
+  std::byte *mapped() const { return m_mapped; }
+
+  /// @brief Makes host writes to specified range of allocation visible to
+  /// device. No-op if memory is host coherent.
+  void flush(VkDeviceSize offset, VkDeviceSize size) const;
+
+  /// @brief Makes device writes to specified range of allocation visible to
+  /// host. No-op if memory is host coherent.
+  void invalidate(VkDeviceSize offset, VkDeviceSize size) const;
+
+  ~DeviceAllocation();
+
+private:
+  friend class DeviceAllocator;
+
+  DeviceAllocator *m_allocator = nullptr;
+  void *m_block = nullptr;
+  TLSFHeap::Handle m_handle = 0u;
+  VkDeviceMemory m_memory = VK_NULL_HANDLE;
+  VkDeviceSize m_offset = 0u;
+  VkDeviceSize m_size = 0u;
+  std::byte *m_mapped = nullptr;
+  uint32_t m_memoryType = 0u;
+  bool m_coherent = false;
+};
+
+struct DeviceAllocatorStatistics {
+  /// Number of live VkDeviceMemory objects, including dedicated ones.
+  uint64_t deviceMemoryCount;
+  /// Number of live allocations.
+  uint64_t allocationCount;
+  /// Bytes of device memory allocated from driver.
+  uint64_t reservedBytes;
+  /// Bytes handed out to allocations.
+  uint64_t usedBytes;
+};
+
+class DeviceAllocator final {
+public:
+  /// @class DeviceAllocator
+  /// Sub-allocates device memory for resources, so that number of
+  /// vkAllocateMemory calls stays far below maxMemoryAllocationCount and
+  /// resource creation rarely hits driver. Memory is requested from driver in
+  /// large blocks which are organized in pools per memory type. Placement
+  /// inside of block is done by TLSF heap. Linear (buffers) and non-linear
+  /// (optimally tiled images) resources are kept in separate pools, so
+  /// bufferImageGranularity never has to be considered. Resources that are
+  /// large or prefer dedicated allocation get their own VkDeviceMemory.
+  ///
+  /// All methods are internally synchronized, each pool has it's own lock.
+
+  /// @param device device to allocate memory on.
+  /// @param blockSize size of blocks requested from driver. Pass 0 for auto.
+  DeviceAllocator(vkw::Device &device, VkDeviceSize blockSize = 0u);
+
+  DeviceAllocator(const DeviceAllocator &) = delete;
+  DeviceAllocator &operator=(const DeviceAllocator &) = delete;
+
+  auto &device() const { return m_device; }
+
+  /// @brief Allocates memory for buffer and binds it.
+  DeviceAllocation allocate(VkBuffer buffer, MemoryUsage usage);
+
+  /// @brief Allocates memory for image and binds it.
+  /// @param linear whether image has VK_IMAGE_TILING_LINEAR tiling.
+  DeviceAllocation allocate(VkImage image, bool linear, MemoryUsage usage);
+
+  /// @brief Allocates memory satisfying requirements without binding it.
+  /// @param linear whether memory is used by buffer or linear image.
+  /// @param dedicated whether to allocate dedicated VkDeviceMemory.
+  DeviceAllocation allocate(const VkMemoryRequirements &requirements,
+                            MemoryUsage usage, bool linear,
+                            bool dedicated = false);
+
+  DeviceAllocatorStatistics statistics() const;
+
+  ~DeviceAllocator();
+
+private:
+  friend class DeviceAllocation;
+
+  struct Block {
+    Block(VkDeviceSize size) : heap(size) {}
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    std::byte *mapped = nullptr;
+    TLSFHeap heap;
+    unsigned pool;
+  };
+
+  struct Pool {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Block>> blocks;
+  };
+
+  DeviceAllocation m_allocate(const VkMemoryRequirements &requirements,
+                              MemoryUsage usage, bool linear, bool dedicated,
+                              VkBuffer dedicatedBuffer,
+                              VkImage dedicatedImage);
+  std::vector<uint32_t> m_candidateTypes(uint32_t typeBits,
+                                         MemoryUsage usage) const;
+  // Returns null handle if driver is out of memory of that type.
+  VkDeviceMemory m_allocateMemory(uint32_t memoryType, VkDeviceSize size,
+                                  VkBuffer dedicatedBuffer,
+                                  VkImage dedicatedImage, std::byte *&mapped);
+  void m_freeMemory(VkDeviceMemory memory, VkDeviceSize size);
+  void m_free(DeviceAllocation &allocation);
+  bool m_isCoherent(uint32_t memoryType) const;
+
+  vkw::Device &m_device;
+  VkPhysicalDeviceMemoryProperties m_memoryProperties;
+  VkDeviceSize m_blockSize;
+  VkDeviceSize m_atomSize;
+  std::array<Pool, VK_MAX_MEMORY_TYPES * 2u> m_pools;
+
+  std::atomic<uint64_t> m_deviceMemoryCount = 0u;
+  std::atomic<uint64_t> m_allocationCount = 0u;
+  std::atomic<uint64_t> m_reservedBytes = 0u;
+  std::atomic<uint64_t> m_usedBytes = 0u;
+};
+
+} // namespace imvk
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "imvk/base/ContextImpl.hpp"
+#include "imvk/base/GpuProfiler.hpp"
 #include "imvk/base/Queue.hpp"
+#include "imvk/base/Submit.hpp"
+#include "imvk/base/Timeline.hpp"
 
 #include "vkw/CommandPool.hpp"
 
+#include <atomic>
+#include <mutex>
+
 namespace imvk {
 
 class EngineBase {
@@ -20,25 +26,73 @@ public:
   /// @param queueInfo create info for engine queue.
   EngineBase(ContextImpl &ctx, const QueueCapsInfo &queueInfo)
       : m_context(ctx), m_queue(m_context.allocateQueue(queueInfo)),
+        m_queueFamilyIndex(m_queue.acquire().get().family().index()),
         m_commandPool(ctx.device(),
                       VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-                      m_queue.acquire().get().family().index()){};
+                      m_queueFamilyIndex),
+        m_timeline(ctx.allocateTimeline()),
+        m_timelineValue(m_timeline.value()),
+        m_pipelineCache(ctx.pipelineCache().createEngineCache()){};
 
   ContextImpl &context() const { return m_context; }
+  /// @brief Returns family of engine's queue. Command pools engine records
+  /// into must be created for that family.
+  unsigned queueFamilyIndex() const { return m_queueFamilyIndex; }
   auto &commandPool() { return m_commandPool; }
   const auto &commandPool() const { return m_commandPool; }
 
-  virtual ~EngineBase() { m_context.freeQueue(m_queue); }
+  /// @brief Returns pipeline cache of this engine. It is not shared with
+  /// other engines, so pipeline creation does not contend on it. It's
+  /// contents are merged into context's cache when it is saved.
+  VkPipelineCache pipelineCache() const { return m_pipelineCache; }
+
+  /// @brief Makes next submission of this engine wait on device until
+  /// specified sync point is reached. Is internally synchronized.
+  /// @param point sync point of any engine of same context.
+  /// @param stages pipeline stages of this engine's work that must wait.
+  void waitFor(const SyncPoint &point, VkPipelineStageFlags stages);
+
+  /// @brief Returns sync point that is reached once all work scheduled on
+  /// this engine so far is complete on device. Point may not be submitted yet
+  /// - device waits on it are still valid and resolve once it's signaled.
+  SyncPoint lastSyncPoint() const {
+    return {&m_timeline, m_timelineValue.load(std::memory_order_acquire)};
+  }
+
+  /// Engine implementation must complete all it's work before this
+  /// destructor runs - timeline is reused by other engines.
+  virtual ~EngineBase() {
+    m_context.pipelineCache().releaseEngineCache(m_pipelineCache);
+    m_context.freeTimeline(m_timeline,
+                           m_timelineValue.load(std::memory_order_acquire));
+    m_context.freeQueue(m_queue);
+  }
 
 protected:
   /// @brief Only engine implementation is expected to have access to the queue.
   /// @return queue
   Queue &queue() const { return m_queue; }
 
+  /// @brief Reserves next point on engine's timeline. Engine implementation
+  /// must signal every reserved point in order with it's submissions.
+  SyncPoint nextSyncPoint() {
+    return {&m_timeline,
+            m_timelineValue.fetch_add(1u, std::memory_order_acq_rel) + 1u};
+  }
+
+  /// @brief Moves waits collected by waitFor() into submit batch.
+  void consumeWaits(SubmitBatch &batch);
+
 private:
   ContextImpl &m_context;
   Queue &m_queue;
+  unsigned m_queueFamilyIndex;
   vkw::CommandPool m_commandPool;
+  TimelineSemaphore &m_timeline;
+  std::atomic<uint64_t> m_timelineValue;
+  VkPipelineCache m_pipelineCache;
+  std::mutex m_waitsMutex;
+  std::vector<std::pair<SyncPoint, VkPipelineStageFlags>> m_pendingWaits;
 };
 
 class Frame;
@@ -55,15 +109,27 @@ public:
   /// @param queueInfo queueInfo passed to EngineBase
   /// @param frameInFlightCount count of expected frames in flight for this
   /// engine.
+  /// @param transientBufferSize size of each frame's transient data buffer in
+  /// bytes. Pass 0 for auto.
+  /// @param gpuScopesPerFrame maximum number of GPU scopes each frame may
+  /// record. Pass 0 to disable GPU profiling.
   FramedEngine(ContextImpl &ctx, const QueueCapsInfo &queueInfo,
-               unsigned frameInFlightCount);
+               unsigned frameInFlightCount, VkDeviceSize transientBufferSize,
+               unsigned gpuScopesPerFrame);
 
   const auto &getFIFCount() const { return m_frameInFlightCount; }
 
   const auto &getDynamicFIFCount() const { return m_dynamicFIFCount; }
 
+  const auto &getTransientBufferSize() const { return m_transientBufferSize; }
+
   void setDynamicFIFCount(unsigned count);
 
+  /// @brief Returns profiler GPU scopes of this engine's frames are collected
+  /// by.
+  GpuProfiler &gpuProfiler() { return m_gpuProfiler; }
+  const GpuProfiler &gpuProfiler() const { return m_gpuProfiler; }
+
 protected:
   void endAndAdvanceFrame();
   unsigned getCurrentFrameId() const { return m_currentFrame; }
@@ -72,6 +138,8 @@ protected:
 
 private:
   const unsigned m_frameInFlightCount;
+  const VkDeviceSize m_transientBufferSize;
+  GpuProfiler m_gpuProfiler;
   std::vector<std::unique_ptr<Frame>> m_frames;
   unsigned m_dynamicFIFCount;
   unsigned m_currentFrame = 0;
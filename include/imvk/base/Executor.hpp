@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace imvk {
+
+/// @brief Unit of work executed by an executor.
+class Job {
+public:
+  virtual void run() = 0;
+  virtual ~Job() = default;
+};
+
+class Executor {
+public:
+  /// @class Executor
+  /// Runs jobs posted to it, e.g. background updates of primitives. User may
+  /// provide their implementation to integrate with application's own job
+  /// system.
+
+  /// @brief Schedules job for execution. Must be internally synchronized.
+  virtual void post(std::shared_ptr<Job> job) = 0;
+
+  virtual ~Executor() = default;
+};
+
+/// @brief Executor that runs job in place.
+class InlineExecutor final : public Executor {
+public:
+  void post(std::shared_ptr<Job> job) override { job->run(); }
+};
+
+class ThreadPool final : public Executor {
+public:
+  /// @class ThreadPool
+  /// Fixed set of worker threads. Each worker has it's own queue, jobs are
+  /// distributed round-robin and idle workers steal from others, so posting
+  /// threads rarely contend on the same lock. Posting wakes an idle worker if
+  /// there is one, so a job never waits behind a busy owner of it's queue.
+
+  /// @param threadCount number of workers. Pass 0 for number of hardware
+  /// threads.
+  explicit ThreadPool(unsigned threadCount = 0u);
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void post(std::shared_ptr<Job> job) override;
+
+  unsigned threadCount() const { return m_workers.size(); }
+
+  /// @brief Executes all jobs posted so far and joins workers.
+  ~ThreadPool() override;
+
+private:
+  struct alignas(64) Worker {
+    std::mutex mutex;
+    std::deque<std::shared_ptr<Job>> jobs;
+    std::thread thread;
+  };
+
+  void m_loop(unsigned index);
+  std::shared_ptr<Job> m_pop(Worker &worker, bool back);
+  std::shared_ptr<Job> m_steal(unsigned index);
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::atomic<unsigned> m_next = 0u;
+  // Jobs queued in all workers. Idle workers sleep until it's non-zero.
+  std::atomic<size_t> m_pending = 0u;
+  std::atomic<unsigned> m_idle = 0u;
+  std::mutex m_idleMutex;
+  std::condition_variable m_idleCv;
+  bool m_stop = false;
+};
+
+/// @brief Completion state of a job. Is usually allocated together with the
+/// job itself.
+class CompletionState {
+public:
+  bool ready() const { return m_done.load(std::memory_order_acquire); }
+
+  void wait() const { m_done.wait(false, std::memory_order_acquire); }
+
+protected:
+  void complete(std::exception_ptr error = nullptr) {
+    m_error = std::move(error);
+    m_done.store(true, std::memory_order_release);
+    m_done.notify_all();
+  }
+
+private:
+  friend class Completion;
+  std::atomic<bool> m_done = false;
+  std::exception_ptr m_error;
+};
+
+/// @brief Lightweight counterpart of std::shared_future<void>.
+class Completion {
+public:
+  Completion() = default;
+  explicit Completion(std::shared_ptr<const CompletionState> state)
+      : m_state(std::move(state)) {}
+
+  bool valid() const { return m_state != nullptr; }
+
+  bool ready() const { return m_state->ready(); }
+
+  void wait() const { m_state->wait(); }
+
+  /// @brief Waits for completion and rethrows exception job ended with.
+  void get() const {
+    wait();
+    if (m_state->m_error)
+      std::rethrow_exception(m_state->m_error);
+  }
+
+private:
+  std::shared_ptr<const CompletionState> m_state;
+};
+
+/// @brief Job running a callable. Job, callable and completion state share
+/// single allocation.
+template <typename F>
+class FunctionJob final : public Job, public CompletionState {
+public:
+  explicit FunctionJob(F function) : m_function(std::move(function)) {}
+
+  void run() override {
+    try {
+      m_function();
+      complete();
+    } catch (...) {
+      complete(std::current_exception());
+    }
+  }
+
+private:
+  F m_function;
+};
+
+/// @brief Posts callable to executor.
+/// @return completion of the callable. Exception thrown by callable is
+/// forwarded to it.
+Completion post(Executor &executor, auto &&function) {
+  auto job =
+      std::make_shared<FunctionJob<std::decay_t<decltype(function)>>>(
+          std::forward<decltype(function)>(function));
+  executor.post(job);
+  return Completion{std::move(job)};
+}
+
+} // namespace imvk
@@ -1,14 +1,58 @@
 #pragma once
 #include "imvk/base/EngineBase.hpp"
+#include "imvk/base/Executor.hpp"
+#include "imvk/base/GpuProfiler.hpp"
+#include "imvk/base/LinearAllocator.hpp"
+#include "imvk/base/PrimitiveTracker.hpp"
+#include "imvk/base/ResourceStateTracker.hpp"
 #include "imvk/base/Utils.hpp"
 
 #include "vkw/CommandBuffer.hpp"
 #include "vkw/CommandPool.hpp"
 
+#include <functional>
+
 namespace imvk {
 
 class ContextImpl;
 class PrimitiveHandleBase;
+class Frame;
+
+class FrameFork final {
+public:
+  /// @class FrameFork
+  /// Set of secondary command buffers of a frame that may be recorded in
+  /// parallel - each of them comes from it's own command pool. Buffers are
+  /// in recording state. join() executes them in primary command buffer of
+  /// the frame in order of their indices, regardless of the order recording
+  /// finished in.
+
+  FrameFork(const FrameFork &) = delete;
+  FrameFork &operator=(const FrameFork &) = delete;
+  FrameFork(FrameFork &&) = default;
+
+  unsigned size() const { return m_commands.size(); }
+
+  /// @brief Returns secondary command buffer with specified index. Each
+  /// buffer may be recorded on any thread, but by one thread at a time.
+  VkCommandBuffer commands(unsigned index) const {
+    return m_commands.at(index);
+  }
+
+  /// @brief Ends recording of all buffers and records their execution in
+  /// the frame. Recording of every buffer must be finished before.
+  void join();
+
+  ~FrameFork() { assert(m_commands.empty() && "fork is not joined"); }
+
+private:
+  friend class Frame;
+  FrameFork(const Frame &frame, std::vector<VkCommandBuffer> commands)
+      : m_frame(frame), m_commands(std::move(commands)) {}
+
+  const Frame &m_frame;
+  std::vector<VkCommandBuffer> m_commands;
+};
 
 class Frame final {
 public:
@@ -22,19 +66,95 @@ public:
 
   const auto &id() const { return m_id; }
 
-  void usePrimitive(const std::shared_ptr<PrimitiveHandleBase> &primitive);
+  /// @brief Keeps primitive alive until device is done with this frame.
+  /// Must be called from thread recording the frame.
+  void
+  usePrimitive(const std::shared_ptr<PrimitiveHandleBase> &primitive) const;
 
   vkw::PrimaryCommandBuffer &commands() const { return m_commandBuffer; }
+
+  /// @brief Forks frame into several secondary command buffers. Must be
+  /// called from thread recording the frame.
+  /// @param count number of secondary command buffers. Fork of 0 buffers
+  /// records nothing on join().
+  /// @param inheritance inheritance info of buffers. If it specifies a render
+  /// pass, buffers continue it and frame must have begun that render pass
+  /// with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. Pass null for
+  /// buffers recorded outside of render pass.
+  FrameFork fork(unsigned count,
+                 const VkCommandBufferInheritanceInfo *inheritance =
+                     nullptr) const;
+
+  using RecordJob = std::function<void(unsigned index, VkCommandBuffer)>;
+
+  /// @brief Forks frame, records each secondary command buffer with job on
+  /// executor and joins it. Blocks until recording is done. Exception thrown
+  /// by any job is rethrown after join.
+  void recordParallel(Executor &executor, unsigned count, const RecordJob &job,
+                      const VkCommandBufferInheritanceInfo *inheritance =
+                          nullptr) const;
+
+  /// @brief Returns allocator of transient data used by this frame only, e.g.
+  /// per-draw uniforms and dynamic vertices. It is reset in begin(), once
+  /// device is done with previous use of the frame, and flushed in end().
+  LinearAllocator &transientAllocator() const { return m_transientAllocator; }
+
+  /// @brief Returns timestamp queries of this frame. Use GpuScope to record
+  /// them.
+  FrameProfiler &profiler() const { return m_profiler; }
+
+  /// @brief Returns tracker of image layouts and resource accesses that
+  /// records barriers into frame's primary command buffer. It is reset in
+  /// begin() and flushed in end(). Must be used from thread recording the
+  /// frame.
+  ResourceStateTracker &resourceStates() const { return m_resourceStates; }
+
   ~Frame();
 
 private:
   FramedEngine &m_engine;
   unsigned m_id;
   mutable vkw::PrimaryCommandBuffer m_commandBuffer;
-  mutable LinearTable<unsigned,
-                      std::pair<std::shared_ptr<PrimitiveHandleBase>, bool>>
-      m_registeredPrimitives;
-  std::vector<unsigned> m_toBeDeleted;
+  mutable LinearAllocator m_transientAllocator;
+  mutable FrameProfiler m_profiler;
+  mutable PrimitiveTracker m_primitives;
+  mutable ResourceStateTracker m_resourceStates;
+
+  // One pool per fork index, so that each index may be recorded on it's own
+  // thread. Pools are reset in begin(), buffers are freed together with them.
+  struct SecondaryPool {
+    SecondaryPool(vkw::Device &device, unsigned queueFamilyIndex)
+        : pool(device, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, queueFamilyIndex) {
+    }
+    vkw::CommandPool pool;
+    std::vector<VkCommandBuffer> commands;
+    unsigned used = 0u;
+  };
+  mutable std::vector<SecondaryPool> m_secondaryPools;
+};
+
+class GpuScope final {
+public:
+  /// @class GpuScope
+  /// Measures device time of commands recorded into frame's primary command
+  /// buffer during lifetime of this object. Scopes may be nested. Results
+  /// are available from engine's GpuProfiler once device is done with the
+  /// frame.
+  ///
+  /// @param name name of scope. Must stay valid until frame is complete on
+  /// device, string literal is expected.
+  GpuScope(const Frame &frame, std::string_view name)
+      : m_frame(frame),
+        m_index(frame.profiler().beginScope(frame.commands(), name)) {}
+
+  GpuScope(const GpuScope &) = delete;
+  GpuScope &operator=(const GpuScope &) = delete;
+
+  ~GpuScope() { m_frame.profiler().endScope(m_frame.commands(), m_index); }
+
+private:
+  const Frame &m_frame;
+  unsigned m_index;
 };
 
 } // namespace imvk
\ No newline at end of file
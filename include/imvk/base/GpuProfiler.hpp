@@ -0,0 +1,161 @@
+#pragma once
+
+#include "vkw/CommandPool.hpp"
+#include "vkw/Device.hpp"
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace imvk {
+
+class Queue;
+
+/// Rolling statistics of one GPU scope. Durations are in milliseconds and
+/// cover last samples of the scope only (see GpuProfiler).
+struct GpuScopeStatistics {
+  std::string name;
+  /// Total number of samples collected.
+  uint64_t count;
+  double last;
+  double average;
+  double min;
+  double max;
+};
+
+class GpuProfiler final {
+public:
+  /// @class GpuProfiler
+  /// Aggregates GPU timestamps recorded by frames of an engine (see
+  /// GpuScope). Frames read their timestamps back once device is done with
+  /// them and hand them over here, so profiling never stalls host.
+  ///
+  /// Scopes are aggregated by name into rolling statistics over last
+  /// windowSize samples. Last traceCapacity scopes are also kept as trace
+  /// events that may be written in Chrome trace format, which is readable by
+  /// chrome://tracing and Perfetto.
+  ///
+  /// Trace events are written in host time domain of trace::now(), so they
+  /// line up with host spans (see Trace.hpp). Device ticks are mapped to it by
+  /// calibrate(). Device and host clocks may drift apart over long runs.
+  ///
+  /// Profiler is disabled if scopesPerFrame is 0 or queue family does not
+  /// support timestamps. Scopes are no-op then.
+  ///
+  /// statistics() and writeChromeTrace() may be called from any thread.
+
+  static constexpr size_t windowSize = 128u;
+
+  /// @param device device frames are recorded on.
+  /// @param queueFamilyIndex family of engine's queue.
+  /// @param scopesPerFrame maximum number of scopes recorded by one frame.
+  /// @param traceCapacity number of last scopes kept as trace events.
+  GpuProfiler(vkw::Device &device, unsigned queueFamilyIndex,
+              unsigned scopesPerFrame, size_t traceCapacity = 16384u);
+
+  GpuProfiler(const GpuProfiler &) = delete;
+  GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+  bool enabled() const { return m_scopesPerFrame; }
+
+  unsigned scopesPerFrame() const { return m_scopesPerFrame; }
+
+  /// @brief Maps device ticks to host time. Writes timestamp on device and
+  /// pairs it with host time read around submission, keeping the tightest of
+  /// several attempts. Blocks until device executes them, so it is meant to
+  /// be called once at engine creation. Until it is called trace events are
+  /// relative to the first collected scope.
+  /// @param queue queue of the family profiler was created for.
+  /// @param commandPool pool of that family that allows resetting command
+  /// buffers.
+  void calibrate(const Queue &queue, vkw::CommandPool &commandPool);
+
+  /// @brief Returns statistics of every scope seen so far, sorted by name.
+  std::vector<GpuScopeStatistics> statistics() const;
+
+  /// @brief Writes collected trace events as Chrome trace JSON.
+  void writeChromeTrace(std::ostream &out) const;
+
+  /// Scope as recorded by a frame. Timestamps are raw device ticks.
+  struct ScopeRecord {
+    std::string_view name;
+    unsigned depth;
+    uint64_t begin;
+    uint64_t end;
+  };
+
+  /// @brief Accounts scopes of one frame. Called by frames.
+  void collect(std::span<const ScopeRecord> scopes);
+
+private:
+  struct Scope {
+    uint64_t count = 0u;
+    double last = 0.0;
+    std::vector<double> window;
+  };
+
+  struct TraceEvent {
+    std::string_view name;
+    uint64_t frame;
+    unsigned depth;
+    double begin;
+    double duration;
+  };
+
+  vkw::Device &m_device;
+  unsigned m_scopesPerFrame;
+  double m_timestampPeriod;
+  uint64_t m_timestampMask;
+  size_t m_traceCapacity;
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, Scope, std::less<>> m_scopes;
+  std::deque<TraceEvent> m_trace;
+  uint64_t m_frameCount = 0u;
+  // Device tick that corresponds to host time m_hostOrigin in nanoseconds.
+  uint64_t m_origin = 0u;
+  uint64_t m_hostOrigin = 0u;
+  bool m_calibrated = false;
+};
+
+class FrameProfiler final {
+public:
+  /// @class FrameProfiler
+  /// Timestamp query pool of one frame. Scopes are recorded into frame's
+  /// primary command buffer. Results of previous use of the frame are read in
+  /// begin(), which must be called once device is done with that use.
+
+  FrameProfiler(vkw::Device &device, GpuProfiler &profiler);
+
+  FrameProfiler(const FrameProfiler &) = delete;
+  FrameProfiler &operator=(const FrameProfiler &) = delete;
+
+  /// @brief Hands results of previous use over to profiler and records reset
+  /// of queries. Must be recorded before any scope.
+  void begin(VkCommandBuffer commands);
+
+  /// @brief Records beginning of scope.
+  /// @return index of scope, or ~0u if profiler is disabled or frame is out
+  /// of scopes.
+  unsigned beginScope(VkCommandBuffer commands, std::string_view name);
+
+  /// @brief Records end of scope returned by beginScope().
+  void endScope(VkCommandBuffer commands, unsigned index);
+
+  ~FrameProfiler();
+
+private:
+  vkw::Device &m_device;
+  GpuProfiler &m_profiler;
+  VkQueryPool m_pool = VK_NULL_HANDLE;
+  std::vector<GpuProfiler::ScopeRecord> m_scopes;
+  std::vector<uint64_t> m_results;
+  unsigned m_depth = 0u;
+};
+
+} // namespace imvk
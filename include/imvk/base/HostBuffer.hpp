@@ -0,0 +1,51 @@
+#pragma once
+
+#include "vkw/Device.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace imvk {
+
+class HostBuffer final {
+public:
+  /// @class HostBuffer
+  /// Buffer that lives in host visible memory and stays persistently mapped
+  /// for the whole duration of it's lifetime. Is used as a source of staging
+  /// and transient data.
+
+  /// @brief HostBuffer constructor
+  /// @param device device to allocate buffer on.
+  /// @param size size of buffer in bytes.
+  /// @param usage buffer usage flags.
+  HostBuffer(vkw::Device &device, VkDeviceSize size, VkBufferUsageFlags usage);
+
+  HostBuffer(const HostBuffer &) = delete;
+  HostBuffer(HostBuffer &&) = delete;
+  HostBuffer &operator=(const HostBuffer &) = delete;
+  HostBuffer &operator=(HostBuffer &&) = delete;
+
+  VkBuffer buffer() const { return m_buffer; }
+
+  VkDeviceSize size() const { return m_size; }
+
+  std::span<std::byte> mapped() const { return {m_mapped, m_size}; }
+
+  /// @brief Makes host writes to specified range visible to device. No-op if
+  /// memory is host coherent.
+  void flush(VkDeviceSize offset, VkDeviceSize size) const;
+
+  ~HostBuffer();
+
+private:
+  vkw::Device &m_device;
+  VkDeviceSize m_size;
+  VkBuffer m_buffer = VK_NULL_HANDLE;
+  VkDeviceMemory m_memory = VK_NULL_HANDLE;
+  VkDeviceSize m_allocationSize = 0;
+  VkDeviceSize m_atomSize = 1;
+  std::byte *m_mapped = nullptr;
+  bool m_coherent = false;
+};
+
+} // namespace imvk
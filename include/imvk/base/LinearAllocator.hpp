@@ -0,0 +1,85 @@
+#pragma once
+#include "imvk/base/HostBuffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace imvk {
+
+/// Sub-allocation of a linear allocator. Data is written through mapped span,
+/// device accesses it through buffer at specified offset (e.g. as dynamic
+/// offset of uniform buffer descriptor or vertex buffer offset).
+struct TransientAllocation {
+  std::span<std::byte> data;
+  VkBuffer buffer;
+  VkDeviceSize offset;
+};
+
+class LinearAllocator final {
+public:
+  /// @class LinearAllocator
+  /// Bump allocator over persistently mapped host visible buffer. Allocation
+  /// bumps the head with a lock-free compare-and-swap loop, individual
+  /// allocations are never freed - whole allocator is reset at once when
+  /// device is done with it's contents.
+  ///
+  /// allocate() may be called concurrently, reset() and flush() must be
+  /// externally synchronized with it.
+
+  /// @param device device to allocate buffer on.
+  /// @param size size of buffer in bytes.
+  /// @param usage usage of buffer. By default buffer is usable as uniform,
+  /// storage, vertex and index buffer.
+  LinearAllocator(vkw::Device &device, VkDeviceSize size,
+                  VkBufferUsageFlags usage =
+                      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+
+  /// @brief Allocates aligned range of buffer. Throws if allocator is out of
+  /// space.
+  /// @param size size of allocation in bytes.
+  /// @param alignment alignment of offset, must be power of 2. Pass 0 for
+  /// minUniformBufferOffsetAlignment of device.
+  TransientAllocation allocate(VkDeviceSize size, VkDeviceSize alignment = 0);
+
+  /// @brief Allocates range and copies data into it.
+  TransientAllocation push(std::span<const std::byte> data,
+                           VkDeviceSize alignment = 0) {
+    auto ret = allocate(data.size(), alignment);
+    std::memcpy(ret.data.data(), data.data(), data.size());
+    return ret;
+  }
+
+  /// @brief Allocates range and copies trivially copyable object into it.
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  TransientAllocation push(const T &value, VkDeviceSize alignment = 0) {
+    return push(std::as_bytes(std::span{&value, 1u}), alignment);
+  }
+
+  /// @brief Makes all allocations made since last reset visible to device.
+  void flush() const { m_buffer.flush(0, used()); }
+
+  /// @brief Releases all allocations. Device must be done with them.
+  void reset() { m_head.store(0u, std::memory_order_relaxed); }
+
+  VkDeviceSize used() const {
+    return std::min(m_head.load(std::memory_order_relaxed), m_buffer.size());
+  }
+
+  VkDeviceSize capacity() const { return m_buffer.size(); }
+
+  VkBuffer buffer() const { return m_buffer.buffer(); }
+
+private:
+  HostBuffer m_buffer;
+  VkDeviceSize m_defaultAlignment;
+  std::atomic<VkDeviceSize> m_head = 0u;
+};
+
+} // namespace imvk
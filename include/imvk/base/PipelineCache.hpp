@@ -0,0 +1,73 @@
+#pragma once
+
+#include "vkw/Device.hpp"
+
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+namespace imvk {
+
+class PipelineCache final {
+public:
+  /// @class PipelineCache
+  /// Context-wide VkPipelineCache that persists between application runs.
+  /// Each engine gets it's own cache to avoid internal synchronization of
+  /// pipeline creation across engines. Those caches are merged into the main
+  /// one when engine releases it and whenever cache is saved.
+  ///
+  /// Cache file consists of imvk header followed by data returned by
+  /// vkGetPipelineCacheData. Header pins device UUID, driver version and data
+  /// checksum, so cache from another device, driver or corrupted cache is
+  /// silently discarded.
+  ///
+  /// All methods are internally synchronized.
+
+  /// @brief Creates cache and populates it from file if it's valid.
+  /// @param device device pipelines are created on.
+  /// @param path path to cache file. Pass empty path to disable persistence.
+  PipelineCache(vkw::Device &device, std::filesystem::path path);
+
+  PipelineCache(const PipelineCache &) = delete;
+  PipelineCache &operator=(const PipelineCache &) = delete;
+
+  /// @brief Returns handle to main cache.
+  VkPipelineCache handle() const { return m_cache; }
+
+  /// @brief Creates cache for engine. It is initialized with current contents
+  /// of main cache.
+  VkPipelineCache createEngineCache();
+
+  /// @brief Merges engine cache into main cache and destroys it.
+  void releaseEngineCache(VkPipelineCache cache);
+
+  /// @brief Merges all engine caches into main cache and atomically replaces
+  /// cache file with it's contents. No-op if persistence is disabled.
+  void save();
+
+  /// @brief Saves cache and destroys all caches. Engine caches must be
+  /// released prior to that.
+  ~PipelineCache();
+
+private:
+  struct FileHeader;
+
+  FileHeader m_header() const;
+  std::vector<char> m_load() const;
+  std::vector<char> m_getData(VkPipelineCache cache) const;
+  void m_mergeEngineCaches();
+
+  vkw::Device &m_device;
+  std::filesystem::path m_path;
+  VkPipelineCache m_cache = VK_NULL_HANDLE;
+  std::vector<VkPipelineCache> m_engineCaches;
+  std::mutex m_mutex;
+
+  uint32_t m_vendorID;
+  uint32_t m_deviceID;
+  uint32_t m_driverVersion;
+  uint8_t m_pipelineCacheUUID[VK_UUID_SIZE];
+  uint8_t m_deviceUUID[VK_UUID_SIZE];
+};
+
+} // namespace imvk
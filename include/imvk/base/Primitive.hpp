@@ -1,12 +1,16 @@
 #pragma once
 
+#include "imvk/base/COW.hpp"
 #include "imvk/base/Frame.hpp"
 
 #include "boost/container/small_vector.hpp"
 
+#include <atomic>
 #include <future>
 #include <memory>
-#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
 
 namespace imvk {
 
@@ -14,8 +18,12 @@ namespace imvk {
 /// Lifetime of this object is controlled via reference counting system.
 class PrimitiveHandleBase {
 public:
-  PrimitiveHandleBase(FramedEngine &engine) {
-    m_frameIds.resize(engine.getFIFCount(), 0u);
+  PrimitiveHandleBase(FramedEngine &engine)
+      : PrimitiveHandleBase(engine.getFIFCount()) {}
+  /// @brief Constructs handle that is not bound to any engine.
+  /// @param frameCount number of frame slots handle may be tracked by.
+  PrimitiveHandleBase(unsigned frameCount) {
+    m_frameIds.resize(frameCount, 0u);
   }
   virtual ~PrimitiveHandleBase() = default;
 
@@ -38,7 +46,8 @@ template <typename T>
 class PrimitiveHandleImpl : public PrimitiveHandleBase, public T {
 public:
   PrimitiveHandleImpl(FramedEngine &engine, auto &&...args)
-      : T(std::forward<decltype(args)...>(args)){};
+      : PrimitiveHandleBase(engine),
+        T(std::forward<decltype(args)>(args)...){};
 };
 
 using PrimitiveHandle = std::shared_ptr<PrimitiveHandleBase>;
@@ -76,8 +85,8 @@ public:
   /// @brief Type-aware wrapper for get()
   /// @param frame
   /// @return Typed shared reference to primitive object.
-  std::shared_ptr<PrimitiveImpl<T>> getImpl(const Frame &frame) const {
-    return std::static_pointer_cast<PrimitiveImpl<T>>(get(frame));
+  std::shared_ptr<PrimitiveHandleImpl<T>> getImpl(const Frame &frame) const {
+    return std::static_pointer_cast<PrimitiveHandleImpl<T>>(get(frame));
   }
 };
 
@@ -92,7 +101,8 @@ public:
 ///        application's thread without external synchronization. Moreover,
 ///        mutiple concurrent calls to reset() for same primitive are allowed.
 ///        However, order of completion for such calls may be different than
-///        order of their submission.
+///        order of their submission. Readers only wait for writers while
+///        handle pointer is swapped, not for allocation or destruction.
 /// @tparam T - Type of primitive.
 /// @tparam Allocator - COWAllocator-like type that must implement
 ///         'allocate' method.
@@ -104,8 +114,7 @@ private:
         : engine(engine), allocator(std::forward<decltype(args)>(args)...) {}
     FramedEngine &engine;
     Allocator allocator;
-    std::shared_ptr<PrimitiveHandleImpl<T>> primitive = nullptr;
-    mutable std::mutex mutex;
+    COWCell<PrimitiveHandleImpl<T>> cell;
   };
 
 public:
@@ -126,94 +135,68 @@ public:
   ///    initialization process may involve lengthy operation on cpu or gpu side
   ///    (like copying, layout transitions etc.). If allocator initializes
   ///    object in-place, it still needs to provide a future that is set to
-  ///    ready state.
-  /// 2. Initialization completion wait.
-  /// 3. Atomic substitution of handle - done by holding a unique lock.
+  ///    ready state. Futures returned by CopyEngine's upload methods may be
+  ///    used here directly.
+  /// 2. Initialization completion wait. If future is a ContinuableFuture
+  ///    (e.g. CopyEngine's UploadFuture) - nobody waits, the next step is
+  ///    chained to it instead.
+  /// 3. Atomic substitution of handle - done by atomic exchange, so get()
+  ///    called concurrently observes either old or new object.
   ///
-  /// This method defers execution of this three steps in async::deferred
-  /// fashion. It does not mutate primitive right away, that's why it is marked
-  /// const and does not block - safe to call in time critical sections. Each
-  /// of this steps may be executed on any executor, everything is internally
-  /// synchronized.
-  /// @param args arguments consumed by allocator's allocate method.
-  /// @return a future to a future to a future of void. Each future is
-  /// responsible for one step of a process, described above.
-  [[nodiscard("remember the futures")]] auto reset(auto &&...args) const {
-    auto stateCopy = m_state;
-    return std::async(std::launch::deferred, [stateCopy = std::move(stateCopy),
-                                              ... args =
-                                                  std::move(args)]() mutable {
-      // Allocate object and get initialization future.
-      auto &&[newPrimitive, initFuture] =
-          std::shared_ptr<PrimitiveHandleImpl<T>>(
-              stateCopy->m_allocator.allocate(
-                  stateCopy->engine, std::forward<decltype(args)>(args)...));
-      return std::async(std::launch::deferred,
-                        [stateCopy = std::move(stateCopy),
-                         newPrimitive = std::move(newPrimitive),
-                         initFuture = std::move(initFuture)]() mutable {
-                          // Wait for initialization process to complete.
-                          initFuture.get();
-                          return std::async(
-                              std::launch::deferred,
-                              [stateCopy = std::move(stateCopy),
-                               newPrimitive = std::move(newPrimitive)]() {
-                                // safely insert new primitive.
-                                auto lock = std::unique_lock{stateCopy->mutex};
-                                auto stale = stateCopy->primitive;
-                                stateCopy->primitive = newPrimitive;
-#if 0
-                                auto &BoundToCp = stateCopy->m_boundTo;
-#endif
-                                lock.unlock();
-                                // delete old primitive after mutex unlock.
-                                stale.reset();
-#if 0
-                                // Notify descriptors sets that are bound to
-                                // this primitive.
-                                for (auto &&[Descriptor, Binding] : BoundToCp) {
-                                  Descriptor->notifyCOW(newPrimitive, Binding);
-                                }
-#endif
-                              });
-                        });
-    });
+  /// Steps are chained in a single job that is posted to context's executor
+  /// (see ContextCreateInfo::executor). This method does not block - safe to
+  /// call in time critical sections.
+  /// @param args arguments consumed by allocator's allocate method. They are
+  /// copied into the job. Spans are copied together with data they view into
+  /// a vector of their own, so caller may release it right away.
+  /// @return completion of the last step.
+  Completion reset(auto &&...args) const
+    requires(sizeof...(args) > 0)
+  {
+    return resetOn(m_state->engine.context().executor(),
+                   std::forward<decltype(args)>(args)...);
+  }
+
+  /// @brief Same as above, but steps are executed on specified executor.
+  Completion resetOn(Executor &executor, auto &&...args) const {
+    auto &state = m_state;
+    return COWCell<PrimitiveHandleImpl<T>>::update(
+        std::shared_ptr<COWCell<PrimitiveHandleImpl<T>>>(state, &state->cell),
+        executor, [state, ... args = m_own(std::forward<decltype(args)>(
+                                 args))]() mutable {
+          return state->allocator.allocate(state->engine, args...);
+        });
   }
 
   /// @brief Invalidate primitive.
-  /// Unlike the reset method above it executes only 3rd step (still deferred)
-  /// This step atomically replaces primitive handle with nullptr.
-  /// @return future of void
-  auto reset() const {
-    auto stateCopy = m_state;
-    return std::async(std::launch::deferred,
-                      [stateCopy = std::move(stateCopy)]() {
-                        // safely erase primitive.
-                        auto lock = std::unique_lock{stateCopy->mutex};
-                        auto stale = stateCopy->primitive;
-                        stateCopy->primitive = nullptr;
-#if 0
-                        auto &BoundToCp = stateCopy->m_boundTo;
-#endif
-                        lock.unlock();
-                        // delete old primitive after mutex unlock.
-                        stale.reset();
-#if 0
-                        // Notify descriptors sets that are bound to
-                        // this primitive.
-                        for (auto &&[Descriptor, Binding] : BoundToCp) {
-                          Descriptor->notifyCOW(nullptr, Binding);
-                        }
-#endif
-                      });
+  /// Unlike the reset method above it executes only 3rd step right away,
+  /// atomically replacing primitive handle with nullptr.
+  void reset() const {
+    auto stale = m_state->cell.exchange(nullptr);
+    // delete old primitive outside of exchange.
+    stale.reset();
   }
 
+  /// @brief Waits for concurrent reset() only while it swaps the handle.
   PrimitiveHandle get(const Frame &frame) const override {
-    auto lock = std::unique_lock{m_state->mutex};
-    return m_state->primitive;
+    return m_state->cell.get();
   }
 
 private:
+  template <typename A> struct IsSpan : std::false_type {};
+  template <typename E, size_t Extent>
+  struct IsSpan<std::span<E, Extent>> : std::true_type {};
+
+  // Job outlives reset() call, so it must not refer to caller's data.
+  static auto m_own(auto &&arg) {
+    using A = std::remove_cvref_t<decltype(arg)>;
+    if constexpr (IsSpan<A>::value)
+      return std::vector<std::remove_cv_t<typename A::element_type>>(
+          arg.begin(), arg.end());
+    else
+      return A(std::forward<decltype(arg)>(arg));
+  }
+
   std::shared_ptr<State> m_state;
 };
 
@@ -233,7 +216,7 @@ public:
   /// @param engine Frame engine this primitive object shall be used for.
   /// @param args parameters for constructor of Allocator object.
   SwapPrimitive(FramedEngine &engine, auto &&...args)
-      : PrimitiveImpl<T>(Primitive::Type::cow), m_engine(engine),
+      : PrimitiveImpl<T>(Primitive::Type::swap), m_engine(engine),
         m_allocator(std::forward<decltype(args)>(args)...),
         m_prims(m_engine.get().getFIFCount()) {}
 
@@ -268,7 +251,7 @@ public:
     m_allocator.write(prim, frame, std::forward<decltype(args)>(args)...);
   }
 
-  std::shared_ptr<PrimitiveHandle> get(const Frame &frame) const override {
+  PrimitiveHandle get(const Frame &frame) const override {
     return m_prims.at(frame.id());
   }
 
@@ -0,0 +1,69 @@
+#pragma once
+#include "imvk/base/Utils.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace imvk {
+
+class PrimitiveHandleBase;
+
+class PrimitiveTracker final {
+public:
+  /// @class PrimitiveTracker
+  /// Keeps primitives used by a frame alive until device is done with them.
+  /// Work is divided into epochs - one per use of the frame. Every use stamps
+  /// primitive with current epoch and moves it to the tail of intrusive
+  /// least-recently-used list, so list stays sorted by last use. Primitive
+  /// not used during previous epoch is released at the beginning of next
+  /// one by popping it from the head of that list. Cost of each epoch is
+  /// proportional to number of uses and releases, not to number of tracked
+  /// primitives.
+  ///
+  /// Not internally synchronized.
+
+  /// @param frameId id of frame slot tracker is stamping primitives for.
+  /// @param reserveChunkSize amount of entries to reserve at once when
+  /// tracker grows.
+  PrimitiveTracker(unsigned frameId, size_t reserveChunkSize = 100u);
+
+  PrimitiveTracker(const PrimitiveTracker &) = delete;
+  PrimitiveTracker &operator=(const PrimitiveTracker &) = delete;
+
+  /// @brief Starts next epoch. Releases primitives that were not used during
+  /// previous epoch.
+  void beginEpoch();
+
+  /// @brief Marks primitive as used during current epoch.
+  void use(const std::shared_ptr<PrimitiveHandleBase> &primitive);
+
+  /// @brief Releases all primitives.
+  void clear();
+
+  size_t size() const { return m_size; }
+
+  uint64_t epoch() const { return m_epoch; }
+
+  ~PrimitiveTracker();
+
+private:
+  struct Entry {
+    std::shared_ptr<PrimitiveHandleBase> primitive;
+    uint64_t epoch;
+    unsigned prev = 0u;
+    unsigned next = 0u;
+  };
+
+  void m_link(unsigned index, Entry &entry);
+  void m_unlink(Entry &entry);
+
+  unsigned m_frameId;
+  LinearTable<unsigned, Entry> m_entries;
+  // Index 0 is never handed out by table, so it serves as null link.
+  unsigned m_head = 0u;
+  unsigned m_tail = 0u;
+  size_t m_size = 0u;
+  uint64_t m_epoch = 0u;
+};
+
+} // namespace imvk
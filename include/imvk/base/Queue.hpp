@@ -1,6 +1,14 @@
 #pragma once
 
+#include "imvk/base/Submit.hpp"
+#include "imvk/base/SubmitBatcher.hpp"
+
+#include "vkw/Device.hpp"
 #include "vkw/Queue.hpp"
+
+#include <chrono>
+#include <functional>
+#include <future>
 #include <mutex>
 
 namespace imvk {
@@ -11,22 +19,51 @@ public:
   /// Accesses to that object are provided either asynchronously or
   /// synchronously, depending on whether a lock was manually introduced.
   /// Either way all accesses to underlying vkw::Queue must be done using
-  /// provided HandedQueue object.
-  Queue(vkw::Queue queue, bool sync) : m_queue(std::move(queue)) {
-    if (sync)
-      m_mutex.emplace();
-  }
+  /// provided HandedQueue object or execute() method.
+  ///
+  /// Alternatively to a lock, queue may be served by a submitter thread. In
+  /// that mode execute() pushes jobs into lock-free ring and returns right
+  /// away, so engines sharing the queue never block each other on hot path.
+  /// acquire() remains available for rare operations and is serialized with
+  /// submitter thread.
+  ///
+  /// Submissions made with submit() are not issued right away but collected
+  /// by the batcher and issued together with single vkQueueSubmit. Pending
+  /// submissions are flushed once coalescing window expires, by a submission
+  /// that carries a fence, by flush(), acquire() and execute().
+  ///
+  /// Locking, submitter thread and batching are implemented by
+  /// SubmitBatcher, this class binds it to the device queue.
+  Queue(vkw::Device &device, vkw::Queue queue, bool sync,
+        std::chrono::microseconds coalescingWindow)
+      : m_device(device), m_queue(std::move(queue)),
+        m_batcher(
+            [this](std::span<SubmitBatch> batches, VkFence fence) {
+              imvk::submit(m_device, m_queue, batches, fence);
+            },
+            sync, coalescingWindow) {}
+
+  Queue(const Queue &) = delete;
+  Queue &operator=(const Queue &) = delete;
 
   /// @brief creates internal mutex if not present.
   /// IMPORTANT: calls to this procedure must be externally synchronized.
-  void introduceLock() {
-    if (!m_mutex)
-      m_mutex.emplace();
-  }
+  void introduceLock() { m_batcher.introduceLock(); }
+
+  /// @brief destroys internal mutex if present. Stops submitter thread if it
+  /// is running.
+  /// IMPORTANT: calls to this procedure must be externally synchronized.
+  void giveUpLock() { m_batcher.giveUpLock(); }
+
+  /// @brief starts submitter thread that owns the queue. Mutex is introduced
+  /// as well to synchronize acquire() calls with that thread.
+  /// IMPORTANT: calls to this procedure must be externally synchronized.
+  void introduceSubmitThread() { m_batcher.introduceSubmitThread(); }
 
-  /// @brief destroys internal mutex if present.
+  /// @brief stops submitter thread if it is running. All jobs pushed so far
+  /// are executed before it stops.
   /// IMPORTANT: calls to this procedure must be externally synchronized.
-  void giveUpLock() { m_mutex.reset(); }
+  void giveUpSubmitThread() { m_batcher.giveUpSubmitThread(); }
 
   /// @brief Scope-based handle for vkw::Queue.
   class HandedQueue {
@@ -44,32 +81,70 @@ public:
 
   /// @brief Grants access to underlying queue, possibly blocking.
   /// If lock is introduced - locks it and returns reference to a queue being
-  /// used. With no lock just returns a queue without blocking.
-  HandedQueue acquire() const {
-    if (m_mutex)
-      return {m_queue, std::unique_lock<std::mutex>{*m_mutex}};
-    else
-      return {m_queue};
-  }
+  /// used. With no lock just returns a queue without blocking. If submitter
+  /// thread is running - jobs pushed before this call are executed first.
+  /// Pending submissions are flushed.
+  HandedQueue acquire() const;
 
   /// @brief Optionally grants access to underlying queue, never blocking.
   /// If lock is introduced - tries to lock it, if succeed - returns reference
   /// to a queue, returns nullopt otherwise. With no lock just returns a queue
-  /// without blocking.
+  /// without blocking. Unlike acquire() it does not wait for jobs pushed to
+  /// submitter thread and leaves pending submissions as is.
   std::optional<HandedQueue> tryAcquire() const {
-    if (m_mutex) {
-      auto lock = std::unique_lock<std::mutex>{*m_mutex, std::try_to_lock};
-      if (lock)
-        return HandedQueue{m_queue, std::move(lock)};
-      else
-        return std::nullopt;
-    } else
-      return HandedQueue{m_queue};
+    auto lock = m_batcher.tryAcquire();
+    if (!lock)
+      return std::nullopt;
+    return HandedQueue{m_queue, std::move(*lock)};
   }
 
+  using Job = std::function<void(vkw::Queue &)>;
+
+  /// @brief Executes job with exclusive access to underlying queue. If
+  /// submitter thread is running - job is pushed to it's ring without
+  /// blocking (unless ring is full). Otherwise job is executed in place
+  /// holding the lock if it's introduced. Jobs pushed by one thread are
+  /// executed in order of pushing. Pending submissions are flushed before
+  /// job is executed.
+  /// @return future that becomes ready once job is executed. Exceptions
+  /// thrown by job are forwarded to it.
+  std::future<void> execute(Job job) const;
+
+  /// @brief Hands submission over to the batcher. Submissions are issued in
+  /// order of this calls, possibly merged with submissions of other engines
+  /// sharing this queue. Semaphores of each batch are kept intact.
+  /// @param batch batch to submit.
+  /// @param fence optional fence. If present - pending submissions are
+  /// flushed right away together with this one and fence is signaled once
+  /// all of them are complete.
+  /// @return future that becomes ready once batch is actually submitted.
+  std::future<void> submit(SubmitBatch batch,
+                           VkFence fence = VK_NULL_HANDLE) const;
+
+  /// @brief Hands several batches over to the batcher at once. They are
+  /// guaranteed to end up in the same vkQueueSubmit call.
+  std::future<void> submit(std::vector<SubmitBatch> batches,
+                           VkFence fence = VK_NULL_HANDLE) const;
+
+  /// @brief Flushes pending submissions without blocking on submitter thread.
+  /// Must be called before waiting on host for completion of work submitted
+  /// with submit().
+  void flush() const;
+
+  /// @brief Flushes pending submissions once their coalescing window expires,
+  /// so that submissions of other engines made meanwhile are merged. Blocks
+  /// until then unless submitter thread is running - it tracks the window
+  /// itself. Suitable for completion threads that are about to wait on host
+  /// for work submitted with submit().
+  void flushCoalesced() const;
+
+  /// @brief Returns statistics of the batcher.
+  SubmitStatistics statistics() const { return m_batcher.statistics(); }
+
 private:
+  vkw::Device &m_device;
   mutable vkw::Queue m_queue;
-  mutable std::optional<std::mutex> m_mutex;
+  SubmitBatcher m_batcher;
 };
 
-} // namespace imvk
\ No newline at end of file
+} // namespace imvk
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "imvk/base/DeviceAllocator.hpp"
+#include "imvk/base/ResourceAccess.hpp"
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace imvk {
+
+class Frame;
+class RenderGraph;
+
+/// Handle of image declared in a RenderGraph.
+struct RenderGraphImage {
+  unsigned index;
+};
+
+/// Handle of buffer declared in a RenderGraph.
+struct RenderGraphBuffer {
+  unsigned index;
+};
+
+/// Description of image owned by a RenderGraph. Usage is deduced from
+/// accesses of passes.
+struct RenderGraphImageInfo {
+  VkFormat format;
+  VkExtent2D extent;
+  VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+  unsigned mipLevels = 1u;
+  unsigned arrayLayers = 1u;
+  /// Usage in addition to the deduced one.
+  VkImageUsageFlags usage = 0u;
+};
+
+struct RenderGraphStatistics {
+  /// Number of passes that are recorded.
+  unsigned passCount;
+  /// Number of passes culled because nothing depends on their results.
+  unsigned culledPassCount;
+  /// Number of vkCmdPipelineBarrier calls per execution.
+  unsigned barrierCount;
+  /// Number of image memory barriers per execution.
+  unsigned imageBarrierCount;
+  /// Number of transient images that are created.
+  unsigned transientImageCount;
+  /// Bytes of device memory transient images occupy.
+  VkDeviceSize transientBytes;
+  /// Bytes transient images would occupy without aliasing.
+  VkDeviceSize unaliasedBytes;
+};
+
+class RenderGraphPass final {
+public:
+  /// @class RenderGraphPass
+  /// Declares accesses of a pass. Pass is assumed to overwrite whole
+  /// contents of resources it writes - resource that is loaded or blended
+  /// to must be declared both as read and write.
+
+  RenderGraphPass &read(RenderGraphImage image, const ResourceAccess &access);
+
+  RenderGraphPass &write(RenderGraphImage image, const ResourceAccess &access);
+
+  RenderGraphPass &read(RenderGraphBuffer buffer, const ResourceAccess &access);
+
+  RenderGraphPass &write(RenderGraphBuffer buffer,
+                         const ResourceAccess &access);
+
+  /// @brief Keeps pass even if no other pass depends on it, e.g. if it
+  /// writes to host visible memory.
+  RenderGraphPass &sideEffects() {
+    m_sideEffects = true;
+    return *this;
+  }
+
+private:
+  friend class RenderGraph;
+
+  using Record = std::function<void(const Frame &, const RenderGraph &)>;
+
+  RenderGraphPass(std::string name, Record record)
+      : m_name(std::move(name)), m_record(std::move(record)) {}
+
+  struct Access {
+    unsigned resource;
+    ResourceAccess access;
+    bool read;
+    bool write;
+  };
+
+  void m_declare(unsigned resource, const ResourceAccess &access, bool read,
+                 bool write);
+
+  std::string m_name;
+  Record m_record;
+  std::vector<Access> m_accesses;
+  bool m_sideEffects = false;
+};
+
+class RenderGraph final {
+public:
+  /// @class RenderGraph
+  /// Frame graph recorded into a Frame. Passes are added in execution order
+  /// and declare how they access resources. compile() then:
+  ///   - culls passes none of which results reach an imported resource or a
+  ///     pass with side effects,
+  ///   - computes barriers: one vkCmdPipelineBarrier before each pass that
+  ///     needs it, covering exactly stages and accesses of preceding passes
+  ///     that the pass depends on, together with layout transitions,
+  ///   - creates transient images, placing those whose lifetimes do not
+  ///     overlap into the same memory.
+  ///
+  /// Passes record their commands themselves. Since graph transitions images
+  /// into layouts passes declare, render passes used by them need no
+  /// external subpass dependencies and should keep attachments in declared
+  /// layout.
+  ///
+  /// Imported resources are owned by user and are bound before each
+  /// execution, e.g. to current swapchain image. They are expected to be in
+  /// declared initial state before execution and are left in declared final
+  /// state. Transient images are valid during execution only.
+  ///
+  /// Graph may be executed by successive frames, including frames in flight
+  /// at the same time: first access of each transient image waits for last
+  /// accesses of images sharing it's memory in previous execution. Graph
+  /// must outlive all frames it was executed in, see
+  /// GraphicsEngine::deferDestruction().
+
+  using Record = RenderGraphPass::Record;
+
+  /// @param allocator allocator transient images are created with.
+  explicit RenderGraph(DeviceAllocator &allocator);
+
+  RenderGraph(const RenderGraph &) = delete;
+  RenderGraph &operator=(const RenderGraph &) = delete;
+
+  /// @brief Declares image owned by graph.
+  RenderGraphImage createImage(std::string name,
+                               const RenderGraphImageInfo &info);
+
+  /// @brief Declares image owned by user.
+  /// @param initial last access of image before execution.
+  /// @param final access image is prepared for after execution.
+  /// @param aspect aspect of image accesses refer to.
+  RenderGraphImage importImage(std::string name, const ResourceAccess &initial,
+                               const ResourceAccess &final,
+                               VkImageAspectFlags aspect =
+                                   VK_IMAGE_ASPECT_COLOR_BIT);
+
+  /// @brief Declares buffer owned by user.
+  /// @param initial last access of buffer before execution.
+  /// @param final access buffer is prepared for after execution.
+  RenderGraphBuffer importBuffer(std::string name,
+                                 const ResourceAccess &initial,
+                                 const ResourceAccess &final);
+
+  /// @brief Adds pass after previously added ones.
+  /// @param record callback recording commands of the pass into frame.
+  /// @return pass to declare accesses on. Reference is valid until graph is
+  /// compiled.
+  RenderGraphPass &addPass(std::string name, Record record);
+
+  /// @brief Culls passes, computes barriers and creates transient images.
+  /// Graph can not be modified afterwards.
+  void compile();
+
+  /// @brief Binds imported image for following executions.
+  void bindImage(RenderGraphImage image, VkImage handle,
+                 VkImageView view = VK_NULL_HANDLE);
+
+  /// @brief Binds imported buffer for following executions.
+  void bindBuffer(RenderGraphBuffer buffer, VkBuffer handle);
+
+  /// @brief Records barriers and passes into frame's primary command buffer.
+  /// Must be called from thread recording the frame.
+  void execute(const Frame &frame) const;
+
+  /// @brief Returns image that is bound to handle during execution.
+  VkImage image(RenderGraphImage image) const;
+
+  /// @brief Returns view of whole image that is bound to handle during
+  /// execution.
+  VkImageView view(RenderGraphImage image) const;
+
+  VkBuffer buffer(RenderGraphBuffer buffer) const;
+
+  /// @brief Returns false if pass was culled. Valid after compile().
+  bool passAlive(std::string_view name) const;
+
+  /// @brief Valid after compile().
+  RenderGraphStatistics statistics() const { return m_statistics; }
+
+  ~RenderGraph();
+
+private:
+  struct Resource {
+    std::string name;
+    bool isImage;
+    bool imported;
+    RenderGraphImageInfo info{};
+    VkImageAspectFlags aspect = 0u;
+    ResourceAccess initial;
+    ResourceAccess final;
+    // Handles, owned by graph for transient images.
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkBuffer buffer = VK_NULL_HANDLE;
+  };
+
+  struct ImageTransition {
+    unsigned resource;
+    VkImageLayout oldLayout;
+    VkImageLayout newLayout;
+    VkAccessFlags srcAccess;
+    VkAccessFlags dstAccess;
+  };
+
+  struct Barrier {
+    VkPipelineStageFlags srcStages = 0u;
+    VkPipelineStageFlags dstStages = 0u;
+    VkAccessFlags srcAccess = 0u;
+    VkAccessFlags dstAccess = 0u;
+    std::vector<ImageTransition> images;
+
+    bool empty() const { return !srcStages && !dstStages && images.empty(); }
+  };
+
+  struct Step {
+    const RenderGraphPass *pass;
+    Barrier barrier;
+  };
+
+  std::vector<bool> m_cull() const;
+  void m_createTransients(const std::vector<const RenderGraphPass *> &passes);
+  void m_computeBarriers(const std::vector<const RenderGraphPass *> &passes);
+  void m_recordBarrier(VkCommandBuffer commands, const Barrier &barrier) const;
+
+  DeviceAllocator &m_allocator;
+  std::vector<Resource> m_resources;
+  // Stable references are handed out by addPass().
+  std::deque<RenderGraphPass> m_passes;
+  bool m_compiled = false;
+
+  std::vector<Step> m_steps;
+  Barrier m_finalBarrier;
+  std::vector<DeviceAllocation> m_memory;
+  RenderGraphStatistics m_statistics{};
+};
+
+} // namespace imvk
@@ -0,0 +1,83 @@
+#pragma once
+#include "imvk/base/DeviceAllocator.hpp"
+
+#include <span>
+
+namespace imvk {
+
+class Buffer {
+public:
+  /// @class Buffer
+  /// VkBuffer with memory sub-allocated from DeviceAllocator.
+
+  /// @param allocator allocator to take memory from.
+  /// @param CI buffer create info.
+  /// @param usage intended memory access pattern.
+  Buffer(DeviceAllocator &allocator, const VkBufferCreateInfo &CI,
+         MemoryUsage usage);
+
+  Buffer(const Buffer &) = delete;
+  Buffer &operator=(const Buffer &) = delete;
+
+  VkBuffer handle() const { return m_buffer; }
+
+  VkDeviceSize size() const { return m_size; }
+
+  const DeviceAllocation &allocation() const { return m_allocation; }
+
+  /// @brief Returns mapped contents of buffer or empty span if memory is not
+  /// host visible.
+  std::span<std::byte> mapped() const {
+    if (!m_allocation.mapped())
+      return {};
+    return {m_allocation.mapped(), m_size};
+  }
+
+  ~Buffer();
+
+private:
+  DeviceAllocator &m_allocator;
+  VkBuffer m_buffer = VK_NULL_HANDLE;
+  VkDeviceSize m_size;
+  DeviceAllocation m_allocation;
+};
+
+class Image {
+public:
+  /// @class Image
+  /// VkImage with memory sub-allocated from DeviceAllocator.
+
+  /// @param allocator allocator to take memory from.
+  /// @param CI image create info.
+  /// @param usage intended memory access pattern.
+  Image(DeviceAllocator &allocator, const VkImageCreateInfo &CI,
+        MemoryUsage usage = MemoryUsage::device);
+
+  Image(const Image &) = delete;
+  Image &operator=(const Image &) = delete;
+
+  VkImage handle() const { return m_image; }
+
+  VkFormat format() const { return m_format; }
+
+  const VkExtent3D &extent() const { return m_extent; }
+
+  unsigned mipLevels() const { return m_mipLevels; }
+
+  unsigned arrayLayers() const { return m_arrayLayers; }
+
+  const DeviceAllocation &allocation() const { return m_allocation; }
+
+  ~Image();
+
+private:
+  DeviceAllocator &m_allocator;
+  VkImage m_image = VK_NULL_HANDLE;
+  VkFormat m_format;
+  VkExtent3D m_extent;
+  unsigned m_mipLevels;
+  unsigned m_arrayLayers;
+  DeviceAllocation m_allocation;
+};
+
+} // namespace imvk
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "vkw/Device.hpp"
+
+#include <array>
+
+namespace imvk {
+
+/// Access flags that modify memory.
+constexpr VkAccessFlags writeAccessMask =
+    VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT |
+    VK_ACCESS_MEMORY_WRITE_BIT;
+
+/// Single way device accesses a resource: pipeline stages, memory accesses
+/// done in them and, for images, layout image must be in. Layout is ignored
+/// for buffers.
+struct ResourceAccess {
+  VkPipelineStageFlags stages = 0u;
+  VkAccessFlags access = 0u;
+  VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  bool writes() const { return access & writeAccessMask; }
+};
+
+/// Dependency of an access on earlier accesses of the same resource.
+struct ResourceDependency {
+  VkPipelineStageFlags srcStages = 0u;
+  VkPipelineStageFlags dstStages = 0u;
+  VkAccessFlags srcAccess = 0u;
+  VkAccessFlags dstAccess = 0u;
+  /// Whether image has to be transitioned from oldLayout to layout of the
+  /// access. Transition itself makes memory available and visible, so
+  /// access masks belong to image barrier then.
+  bool transition = false;
+  VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  bool empty() const { return !srcStages && !dstStages && !transition; }
+};
+
+struct ResourceState {
+  /// @class ResourceState
+  /// Known state of a resource, or of a single image subresource, between
+  /// accesses. Remembers last write and reads that followed it, so that each
+  /// access waits only for what it depends on: reads wait for last write,
+  /// writes wait for everything since it, and a read that an earlier
+  /// dependency already made the write visible to waits for nothing.
+
+  VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  /// Stages and accesses of last write.
+  VkPipelineStageFlags writeStages = 0u;
+  VkAccessFlags writeAccess = 0u;
+  /// Stages that read resource since last write.
+  VkPipelineStageFlags readStages = 0u;
+  /// Accesses last write is visible to, per stage bit.
+  std::array<VkAccessFlags, 32> visible{};
+
+  /// @brief Returns state of resource right after access.
+  /// @param write whether access is treated as a write, i.e. whether
+  /// following reads have to wait for it.
+  static ResourceState after(const ResourceAccess &access, bool write);
+
+  /// @brief Moves state past access and returns dependency access has.
+  /// @param write whether access modifies resource.
+  /// @param image whether resource is image, so that layout matters.
+  ResourceDependency advance(const ResourceAccess &access, bool write,
+                             bool image);
+};
+
+/// Accesses commonly used by passes.
+namespace access {
+
+inline ResourceAccess colorAttachmentWrite() {
+  return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+}
+
+/// @brief Color attachment that is loaded or blended to.
+inline ResourceAccess colorAttachmentReadWrite() {
+  return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+          VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+              VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+}
+
+inline ResourceAccess depthStencilAttachmentWrite() {
+  return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+              VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+              VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+}
+
+/// @brief Depth test without depth writes.
+inline ResourceAccess depthStencilAttachmentRead() {
+  return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+              VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+          VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+}
+
+inline ResourceAccess sampledRead(VkPipelineStageFlags stages) {
+  return {stages, VK_ACCESS_SHADER_READ_BIT,
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+}
+
+inline ResourceAccess storageRead(VkPipelineStageFlags stages) {
+  return {stages, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL};
+}
+
+inline ResourceAccess storageWrite(VkPipelineStageFlags stages) {
+  return {stages, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+}
+
+inline ResourceAccess storageReadWrite(VkPipelineStageFlags stages) {
+  return {stages, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+          VK_IMAGE_LAYOUT_GENERAL};
+}
+
+inline ResourceAccess uniformRead(VkPipelineStageFlags stages) {
+  return {stages, VK_ACCESS_UNIFORM_READ_BIT};
+}
+
+inline ResourceAccess vertexRead() {
+  return {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+          VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT};
+}
+
+inline ResourceAccess indirectRead() {
+  return {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+          VK_ACCESS_INDIRECT_COMMAND_READ_BIT};
+}
+
+inline ResourceAccess transferRead() {
+  return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL};
+}
+
+inline ResourceAccess transferWrite() {
+  return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+}
+
+} // namespace access
+
+} // namespace imvk
@@ -0,0 +1,72 @@
+#pragma once
+#include "imvk/base/Primitive.hpp"
+#include "imvk/base/Resource.hpp"
+
+#include <future>
+#include <span>
+
+namespace imvk {
+
+/// @brief SwapAllocator for buffers that are written by host every frame.
+/// Memory is taken from context's device allocator and must be host visible.
+/// Usage:
+///   SwapPrimitive<Buffer, BufferSwapAllocator> uniforms{engine, CI};
+///   uniforms.resetAll();
+///   ...
+///   uniforms.write(frame, offset, data);
+class BufferSwapAllocator {
+public:
+  BufferSwapAllocator(const VkBufferCreateInfo &CI,
+                      MemoryUsage usage = MemoryUsage::dynamic);
+
+  std::shared_ptr<PrimitiveHandleImpl<Buffer>>
+  allocate(FramedEngine &engine) const;
+
+  /// @brief Copies data into buffer of the frame. Since frame's buffer is not
+  /// accessed by device until frame is submitted no synchronization is needed.
+  void write(Buffer &buffer, const Frame &frame, VkDeviceSize offset,
+             std::span<const std::byte> data) const;
+
+private:
+  VkBufferCreateInfo m_CI;
+  MemoryUsage m_usage;
+};
+
+/// @brief SwapAllocator for images, e.g. per-frame render targets. Contents
+/// are written by device, so it has no write method.
+class ImageSwapAllocator {
+public:
+  ImageSwapAllocator(const VkImageCreateInfo &CI) : m_CI(CI) {}
+
+  std::shared_ptr<PrimitiveHandleImpl<Image>>
+  allocate(FramedEngine &engine) const;
+
+private:
+  VkImageCreateInfo m_CI;
+};
+
+/// @brief COWAllocator for buffers initialized by host in place. New buffer
+/// is created for every reset, so it's size follows size of data. See
+/// BufferUploadAllocator for device local buffers.
+/// Usage:
+///   COWPrimitive<Buffer, BufferCOWAllocator> vertices{engine, usage};
+///   vertices.reset(data).wait();
+class BufferCOWAllocator {
+public:
+  BufferCOWAllocator(VkBufferUsageFlags usage,
+                     MemoryUsage memoryUsage = MemoryUsage::upload)
+      : m_usage(usage), m_memoryUsage(memoryUsage) {}
+
+  /// @param data initial contents of buffer. Must stay alive during this
+  /// call. COWPrimitive::reset() calls it from the job and keeps a copy of
+  /// spans passed to it until then.
+  std::pair<std::shared_ptr<PrimitiveHandleImpl<Buffer>>,
+            std::shared_future<void>>
+  allocate(FramedEngine &engine, std::span<const std::byte> data) const;
+
+private:
+  VkBufferUsageFlags m_usage;
+  MemoryUsage m_memoryUsage;
+};
+
+} // namespace imvk
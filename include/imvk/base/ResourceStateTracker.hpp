@@ -0,0 +1,123 @@
+#pragma once
+
+#include "imvk/base/ResourceAccess.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace imvk {
+
+class ResourceStateTracker final {
+public:
+  /// @class ResourceStateTracker
+  /// Tracks layout and last accesses of images, per mip level and array
+  /// layer, and of buffers during recording of a command buffer. Instead of
+  /// recording a barrier per transition, callers request accesses with
+  /// require(). Tracker works out what each of them depends on and
+  /// accumulates it into single pending barrier, which flush() records as
+  /// one vkCmdPipelineBarrier waiting for exactly stages and accesses
+  /// requested accesses depend on.
+  ///
+  /// Pending barrier must be flushed before commands doing requested
+  /// accesses are recorded. Request that depends on access requested since
+  /// last flush flushes pending barrier first, so requests are never
+  /// reordered.
+  ///
+  /// Resources must be tracked before they are required, with state they
+  /// are in before the command buffer. Not internally synchronized.
+
+  /// @param device device commands are recorded with.
+  /// @param commands command buffer barriers are recorded into.
+  ResourceStateTracker(vkw::Device &device, VkCommandBuffer commands)
+      : m_device(device), m_commands(commands) {}
+
+  ResourceStateTracker(const ResourceStateTracker &) = delete;
+  ResourceStateTracker &operator=(const ResourceStateTracker &) = delete;
+
+  /// @brief Starts tracking image. Tracking image again restarts it.
+  /// @param initial last access of image before the command buffer. All
+  /// subresources are in it's layout.
+  /// @param aspect aspect of image barriers refer to.
+  void track(VkImage image, const ResourceAccess &initial,
+             unsigned mipLevels = 1u, unsigned arrayLayers = 1u,
+             VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+
+  /// @brief Starts tracking buffer. Tracking buffer again restarts it.
+  /// @param initial last access of buffer before the command buffer.
+  void track(VkBuffer buffer, const ResourceAccess &initial);
+
+  bool tracked(VkImage image) const { return m_images.contains(image); }
+
+  bool tracked(VkBuffer buffer) const { return m_buffers.contains(buffer); }
+
+  /// @brief Requests access to range of image subresources. Aspect of range
+  /// is ignored.
+  void require(VkImage image, const VkImageSubresourceRange &range,
+               const ResourceAccess &access);
+
+  /// @brief Requests access to all subresources of image.
+  void require(VkImage image, const ResourceAccess &access);
+
+  void require(VkBuffer buffer, const ResourceAccess &access);
+
+  /// @brief Returns layout subresource is in once pending barrier is
+  /// flushed.
+  VkImageLayout layout(VkImage image, unsigned mipLevel = 0u,
+                       unsigned arrayLayer = 0u) const;
+
+  /// @brief Records pending barrier, if any.
+  void flush();
+
+  /// @brief Returns number of vkCmdPipelineBarrier calls recorded since
+  /// last reset().
+  unsigned barrierCount() const { return m_barrierCount; }
+
+  /// @brief Stops tracking all resources and drops pending barrier. Must be
+  /// called whenever command buffer is reset.
+  void reset();
+
+private:
+  // State of a resource or subresource, with numbers of batches it was
+  // last accessed and last written or transitioned in.
+  struct Entry {
+    ResourceState state;
+    uint64_t batch = 0u;
+    uint64_t writeBatch = 0u;
+  };
+
+  struct Image {
+    VkImageAspectFlags aspect;
+    unsigned mipLevels;
+    unsigned arrayLayers;
+    // Indexed by mipLevel * arrayLayers + arrayLayer.
+    std::vector<Entry> subresources;
+  };
+
+  // Applies access to entry, flushing pending barrier if it depends on
+  // access required in it. Returns dependency that is still to be recorded.
+  ResourceDependency m_advance(Entry &entry, const ResourceAccess &access,
+                               bool image);
+
+  void m_addImageBarrier(VkImage image, const Image &tracked,
+                         const ResourceDependency &dependency,
+                         VkImageLayout newLayout, unsigned mipLevel,
+                         unsigned arrayLayer);
+
+  vkw::Device &m_device;
+  VkCommandBuffer m_commands;
+  std::unordered_map<VkImage, Image> m_images;
+  std::unordered_map<VkBuffer, Entry> m_buffers;
+
+  // Pending barrier. Batch 0 is never pending, so that fresh entries are
+  // not taken for required in it.
+  uint64_t m_batch = 1u;
+  VkPipelineStageFlags m_srcStages = 0u;
+  VkPipelineStageFlags m_dstStages = 0u;
+  VkAccessFlags m_srcAccess = 0u;
+  VkAccessFlags m_dstAccess = 0u;
+  std::vector<VkImageMemoryBarrier> m_imageBarriers;
+  unsigned m_barrierCount = 0u;
+};
+
+} // namespace imvk
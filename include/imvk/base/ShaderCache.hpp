@@ -0,0 +1,81 @@
+#pragma once
+#include "imvk/base/Shader.hpp"
+
+#include <array>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace imvk {
+
+struct ShaderCacheStatistics {
+  /// Requests served by already loaded module.
+  uint64_t hits;
+  /// Requests that triggered load from underlying factory.
+  uint64_t misses;
+  /// Requests that found module being loaded by another thread and waited
+  /// for that load instead of starting a new one.
+  uint64_t coalesced;
+};
+
+class CachingShaderFactory final : public ShaderFactory {
+public:
+  /// @class CachingShaderFactory
+  /// Decorates any shader factory with a concurrent cache of modules. Each
+  /// module is requested from underlying factory once, all subsequent
+  /// requests return the same object. Concurrent requests of a module that
+  /// is not loaded yet share single load.
+  ///
+  /// Failed loads are not cached - exception is forwarded to every request
+  /// that waited on that load, and next request retries it.
+
+  /// @param factory underlying factory. Must outlive this object. It is
+  /// called without any lock held, so loads of different modules proceed in
+  /// parallel.
+  CachingShaderFactory(ShaderFactory &factory) : m_factory(factory) {}
+
+  std::shared_ptr<vkw::SPIRVModule> getModule(std::string_view name) override;
+
+  /// @brief Drops all cached modules. Modules already handed out stay valid.
+  void clear();
+
+  ShaderCacheStatistics statistics() const {
+    return {m_hits.load(std::memory_order_relaxed),
+            m_misses.load(std::memory_order_relaxed),
+            m_coalesced.load(std::memory_order_relaxed)};
+  }
+
+private:
+  struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const {
+      return std::hash<std::string_view>{}(name);
+    }
+  };
+
+  using ModuleFuture = std::shared_future<std::shared_ptr<vkw::SPIRVModule>>;
+
+  struct Entry {
+    ModuleFuture future;
+    // Tells entries apart since shared_future has no identity comparison.
+    uint64_t ticket;
+  };
+
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry, NameHash, std::equal_to<>> modules;
+    uint64_t nextTicket = 0u;
+  };
+
+  static constexpr size_t m_shardCount = 16u;
+
+  ShaderFactory &m_factory;
+  std::array<Shard, m_shardCount> m_shards;
+  std::atomic<uint64_t> m_hits = 0u;
+  std::atomic<uint64_t> m_misses = 0u;
+  std::atomic<uint64_t> m_coalesced = 0u;
+};
+
+} // namespace imvk
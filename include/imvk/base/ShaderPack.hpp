@@ -0,0 +1,57 @@
+#pragma once
+#include "imvk/base/Shader.hpp"
+#include "imvk/base/ShaderPackFormat.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <span>
+
+namespace imvk {
+
+class ShaderPack final : public ShaderFactory {
+public:
+  /// @class ShaderPack
+  /// Shader factory backed by a single pack file produced by imvk_shader_pack
+  /// tool. File is memory-mapped once upon construction and lookups do no
+  /// I/O. Each module is created from mapped code and keeps it's own copy of
+  /// it, so modules may outlive the pack.
+  ///
+  /// Lookups are read-only, so all methods may be called concurrently.
+
+  /// @brief Maps pack file and validates it's header and index.
+  /// @param path path to the pack file.
+  ShaderPack(const std::filesystem::path &path);
+
+  ShaderPack(const ShaderPack &) = delete;
+  ShaderPack &operator=(const ShaderPack &) = delete;
+
+  /// @brief Returns mapped SPIR-V code of shader or nullopt if there is no
+  /// shader with such name in the pack.
+  std::optional<std::span<const uint32_t>> find(std::string_view name) const;
+
+  /// @brief Returns module of shader with specified name. Throws if there is
+  /// no such shader.
+  std::shared_ptr<vkw::SPIRVModule> getModule(std::string_view name) override;
+
+  /// @brief Returns number of shaders in the pack.
+  size_t size() const { return m_index.size(); }
+
+  ~ShaderPack() override;
+
+private:
+  void m_map(const std::filesystem::path &path);
+  void m_unmap();
+  void m_validate(const std::filesystem::path &path);
+
+  const std::byte *m_data = nullptr;
+  size_t m_size = 0;
+#ifdef _WIN32
+  void *m_file = nullptr;
+  void *m_mapping = nullptr;
+#endif
+
+  std::span<const shader_pack::Entry> m_index;
+  std::string_view m_strings;
+};
+
+} // namespace imvk
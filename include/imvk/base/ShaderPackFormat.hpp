@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace imvk::shader_pack {
+
+/// Layout of shader pack file. All integers are little-endian, all offsets are
+/// relative to the beginning of file.
+///
+///   Header
+///   Entry[entryCount]  - sorted by (nameHash, name)
+///   char[stringsSize]  - names, not null-terminated
+///   uint32_t[]         - SPIR-V code of each entry, 4-byte aligned
+///
+/// Index is sorted by name hash, so lookup is binary search over integers
+/// followed by name comparison of (almost always) single candidate.
+
+inline constexpr char magic[8] = {'I', 'M', 'V', 'K', 'S', 'P', 'K', '\0'};
+inline constexpr uint32_t version = 1u;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t entryCount;
+  uint64_t indexOffset;
+  uint64_t stringsOffset;
+  uint64_t stringsSize;
+};
+
+struct Entry {
+  uint64_t nameHash;
+  uint32_t nameOffset;
+  uint32_t nameSize;
+  uint64_t codeOffset;
+  uint64_t codeSize;
+};
+
+/// @brief FNV-1a hash of shader name.
+constexpr uint64_t hashName(std::string_view name) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (auto c : name) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+} // namespace imvk::shader_pack
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "imvk/base/Timeline.hpp"
+
+#include "vkw/Queue.hpp"
+
+#include <span>
+#include <vector>
+
+namespace imvk {
+
+class SubmitBatch final {
+public:
+  /// @class SubmitBatch
+  /// Owning counterpart of VkSubmitInfo that supports both binary and
+  /// timeline semaphores. VkSubmitInfo returned by info() points into storage
+  /// of this object and is valid until it's next modification.
+
+  SubmitBatch() = default;
+  SubmitBatch(const SubmitBatch &another) { *this = another; }
+  SubmitBatch(SubmitBatch &&another) = default;
+  SubmitBatch &operator=(const SubmitBatch &another);
+  SubmitBatch &operator=(SubmitBatch &&another) = default;
+
+  SubmitBatch &addCommandBuffer(VkCommandBuffer commandBuffer) {
+    m_commandBuffers.push_back(commandBuffer);
+    return *this;
+  }
+
+  /// @brief Adds wait on binary semaphore.
+  SubmitBatch &addWait(VkSemaphore semaphore, VkPipelineStageFlags stages) {
+    return m_addWait(semaphore, stages, 0u);
+  }
+
+  /// @brief Adds wait on sync point. Default constructed points are ignored.
+  SubmitBatch &addWait(const SyncPoint &point, VkPipelineStageFlags stages) {
+    if (!point)
+      return *this;
+    return m_addWait(point.timeline->handle(), stages, point.value);
+  }
+
+  /// @brief Adds signal of binary semaphore.
+  SubmitBatch &addSignal(VkSemaphore semaphore) {
+    return m_addSignal(semaphore, 0u);
+  }
+
+  /// @brief Adds signal of sync point.
+  SubmitBatch &addSignal(const SyncPoint &point) {
+    if (!point)
+      return *this;
+    return m_addSignal(point.timeline->handle(), point.value);
+  }
+
+  const VkSubmitInfo &info();
+
+private:
+  SubmitBatch &m_addWait(VkSemaphore semaphore, VkPipelineStageFlags stages,
+                         uint64_t value) {
+    m_waitSemaphores.push_back(semaphore);
+    m_waitStages.push_back(stages);
+    m_waitValues.push_back(value);
+    return *this;
+  }
+  SubmitBatch &m_addSignal(VkSemaphore semaphore, uint64_t value) {
+    m_signalSemaphores.push_back(semaphore);
+    m_signalValues.push_back(value);
+    return *this;
+  }
+
+  std::vector<VkCommandBuffer> m_commandBuffers;
+  std::vector<VkSemaphore> m_waitSemaphores;
+  std::vector<VkPipelineStageFlags> m_waitStages;
+  std::vector<uint64_t> m_waitValues;
+  std::vector<VkSemaphore> m_signalSemaphores;
+  std::vector<uint64_t> m_signalValues;
+  VkTimelineSemaphoreSubmitInfo m_timelineInfo{};
+  VkSubmitInfo m_info{};
+};
+
+/// @brief Statistics of submission batching.
+struct SubmitStatistics {
+  /// Number of batches handed over to the batcher.
+  uint64_t batches = 0u;
+  /// Number of vkQueueSubmit calls issued for them.
+  uint64_t submitCalls = 0u;
+
+  /// @brief Returns number of vkQueueSubmit calls saved by batching.
+  uint64_t saved() const { return batches - submitCalls; }
+};
+
+/// @brief Submits batches to queue with single vkQueueSubmit call.
+/// IMPORTANT: access to queue must be externally synchronized.
+void submit(vkw::Device &device, vkw::Queue &queue,
+            std::span<SubmitBatch> batches, VkFence fence = VK_NULL_HANDLE);
+
+} // namespace imvk
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "imvk/base/Submit.hpp"
+#include "imvk/base/Utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace imvk {
+
+class SubmitBatcher {
+public:
+  /// @class SubmitBatcher
+  /// Device independent core of Queue: serializes access to a queue either
+  /// with a lock or with a submitter thread, and coalesces submissions into
+  /// single calls of the sink. Queue forwards to it, sink issues
+  /// vkQueueSubmit there. Sink may be replaced with a stub to exercise
+  /// batching without a device.
+  ///
+  /// See Queue for semantics of every method.
+
+  /// @brief Issues batches with single call. Is called with exclusive access
+  /// to the queue. Exceptions are forwarded to futures of batches.
+  using Sink = std::function<void(std::span<SubmitBatch>, VkFence)>;
+  /// @brief Job executed with exclusive access to the queue.
+  using Job = std::function<void()>;
+
+  SubmitBatcher(Sink sink, bool sync,
+                std::chrono::microseconds coalescingWindow)
+      : m_sink(std::move(sink)), m_coalescingWindow(coalescingWindow) {
+    if (sync)
+      m_mutex.emplace();
+  }
+
+  SubmitBatcher(const SubmitBatcher &) = delete;
+  SubmitBatcher &operator=(const SubmitBatcher &) = delete;
+
+  /// IMPORTANT: calls to this procedure must be externally synchronized.
+  void introduceLock() {
+    if (!m_mutex)
+      m_mutex.emplace();
+  }
+
+  /// IMPORTANT: calls to this procedure must be externally synchronized.
+  void giveUpLock() {
+    giveUpSubmitThread();
+    m_mutex.reset();
+  }
+
+  /// IMPORTANT: calls to this procedure must be externally synchronized.
+  void introduceSubmitThread();
+
+  /// IMPORTANT: calls to this procedure must be externally synchronized.
+  void giveUpSubmitThread();
+
+  /// @brief Waits for jobs pushed to submitter thread, takes the lock if it
+  /// is introduced and flushes pending submissions.
+  /// @return lock held, empty if there is no lock.
+  std::unique_lock<std::mutex> acquire() const;
+
+  /// @brief Tries to take the lock without blocking.
+  /// @return lock held, empty if there is no lock, nullopt if it is taken.
+  std::optional<std::unique_lock<std::mutex>> tryAcquire() const {
+    if (!m_mutex)
+      return std::unique_lock<std::mutex>{};
+    auto lock = std::unique_lock<std::mutex>{*m_mutex, std::try_to_lock};
+    if (!lock)
+      return std::nullopt;
+    return lock;
+  }
+
+  std::future<void> execute(Job job) const;
+
+  std::future<void> submit(std::vector<SubmitBatch> batches,
+                           VkFence fence = VK_NULL_HANDLE) const;
+
+  void flush() const;
+
+  void flushCoalesced() const;
+
+  SubmitStatistics statistics() const {
+    return {m_batches.load(std::memory_order_relaxed),
+            m_submitCalls.load(std::memory_order_relaxed)};
+  }
+
+  ~SubmitBatcher() { giveUpSubmitThread(); }
+
+private:
+  struct Task {
+    enum class Kind { job, submit, stop };
+    Kind kind;
+    Job job;
+    std::vector<SubmitBatch> batches;
+    VkFence fence = VK_NULL_HANDLE;
+    std::promise<void> promise;
+  };
+
+  struct Submitter {
+    Submitter() : ring(256u) {}
+    MPSCRing<Task> ring;
+    std::atomic<uint64_t> pushed = 0u;
+    // Set while submitter thread waits on wakeCv - producers take the mutex
+    // to notify only then.
+    std::atomic<bool> sleeping = false;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;
+    std::thread thread;
+  };
+
+  void m_push(Task &&task) const;
+  void m_submitLoop();
+  void m_drain() const;
+  // Must be called with exclusive access to the queue.
+  void m_enqueueSubmit(Task &&task) const;
+  void m_flushPending(VkFence fence = VK_NULL_HANDLE) const;
+  // Must be called with m_pendingMutex held.
+  void m_issuePending(VkFence fence) const;
+
+  Sink m_sink;
+  mutable std::optional<std::mutex> m_mutex;
+  std::unique_ptr<Submitter> m_submitter;
+
+  const std::chrono::microseconds m_coalescingWindow;
+  // Guards pending submissions and calls of the sink. Taken even without
+  // m_mutex: engine's completion thread may call flushCoalesced() while
+  // engine's own thread submits to an unshared queue.
+  mutable std::mutex m_pendingMutex;
+  mutable std::vector<SubmitBatch> m_pendingBatches;
+  mutable std::vector<std::promise<void>> m_pendingPromises;
+  mutable std::chrono::steady_clock::time_point m_pendingSince;
+  mutable std::atomic<uint64_t> m_batches = 0u;
+  mutable std::atomic<uint64_t> m_submitCalls = 0u;
+};
+
+} // namespace imvk
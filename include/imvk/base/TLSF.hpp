@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace imvk {
+
+class TLSFHeap final {
+public:
+  /// @class TLSFHeap
+  /// Two-level segregated fit placement over an abstract range of offsets.
+  /// It does not own any memory - it only decides where allocations go, so it
+  /// can manage device memory blocks the host can not access. Both allocation
+  /// and free are O(1): free ranges are kept in size class lists indexed by
+  /// two levels of bitmaps, and neighbouring free ranges are merged on free.
+  ///
+  /// Not internally synchronized.
+
+  using Handle = uint32_t;
+
+  struct Allocation {
+    uint64_t offset;
+    Handle handle;
+  };
+
+  /// @param size size of managed range.
+  explicit TLSFHeap(uint64_t size);
+
+  /// @brief Places allocation of specified size and alignment.
+  /// @param alignment alignment of offset, must be power of 2.
+  /// @return nullopt if there is no free range large enough.
+  std::optional<Allocation> allocate(uint64_t size, uint64_t alignment = 1u);
+
+  /// @brief Releases allocation.
+  void free(Handle handle);
+
+  uint64_t size() const { return m_size; }
+
+  /// @brief Returns sum of sizes of all live allocations, including alignment
+  /// padding that could not be returned to heap.
+  uint64_t used() const { return m_used; }
+
+  bool empty() const { return m_used == 0u; }
+
+private:
+  static constexpr unsigned m_slBits = 5u;
+  static constexpr unsigned m_slCount = 1u << m_slBits;
+  static constexpr unsigned m_flCount = 64u - m_slBits + 1u;
+  static constexpr Handle m_null = std::numeric_limits<Handle>::max();
+
+  struct Block {
+    uint64_t offset;
+    uint64_t size;
+    Handle prevPhysical = m_null;
+    Handle nextPhysical = m_null;
+    Handle prevFree = m_null;
+    Handle nextFree = m_null;
+    bool free = false;
+  };
+
+  static std::pair<unsigned, unsigned> m_mapping(uint64_t size);
+
+  Handle m_newBlock();
+  void m_insertFree(Handle block);
+  void m_removeFree(Handle block);
+  Handle m_findFree(uint64_t size);
+  // Cuts block in two at specified distance from it's beginning, returns the
+  // second part.
+  Handle m_split(Handle block, uint64_t size);
+  // Merges block with next physical block, both must not be in free lists.
+  void m_merge(Handle block, Handle next);
+
+  uint64_t m_size;
+  uint64_t m_used = 0u;
+  std::vector<Block> m_blocks;
+  std::vector<Handle> m_unusedBlocks;
+  uint64_t m_flBitmap = 0u;
+  std::array<uint32_t, m_flCount> m_slBitmaps{};
+  std::array<std::array<Handle, m_slCount>, m_flCount> m_freeLists;
+};
+
+} // namespace imvk
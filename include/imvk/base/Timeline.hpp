@@ -0,0 +1,65 @@
+#pragma once
+
+#include "vkw/Device.hpp"
+
+#include <cstdint>
+#include <limits>
+
+namespace imvk {
+
+class TimelineSemaphore final {
+public:
+  /// @class TimelineSemaphore
+  /// Owns VkSemaphore of VK_SEMAPHORE_TYPE_TIMELINE type. Requires
+  /// timelineSemaphore device feature to be enabled.
+
+  TimelineSemaphore(vkw::Device &device, uint64_t initialValue = 0u);
+
+  TimelineSemaphore(const TimelineSemaphore &) = delete;
+  TimelineSemaphore(TimelineSemaphore &&) = delete;
+  TimelineSemaphore &operator=(const TimelineSemaphore &) = delete;
+  TimelineSemaphore &operator=(TimelineSemaphore &&) = delete;
+
+  VkSemaphore handle() const { return m_semaphore; }
+
+  /// @brief Returns current counter value as seen by host. Never blocks.
+  uint64_t value() const;
+
+  /// @brief Blocks until counter reaches specified value.
+  /// @param value value to wait for.
+  /// @param timeout timeout in nanoseconds.
+  /// @return false if timeout expired, true otherwise.
+  bool wait(uint64_t value,
+            uint64_t timeout = std::numeric_limits<uint64_t>::max()) const;
+
+  /// @brief Sets counter to specified value from host.
+  void signal(uint64_t value);
+
+  ~TimelineSemaphore();
+
+private:
+  vkw::Device &m_device;
+  VkSemaphore m_semaphore = VK_NULL_HANDLE;
+};
+
+/// @brief Point on a timeline of some engine. It is reached once all work
+/// engine submitted up to it is complete on device. Sync points may be waited
+/// on by any other engine on device or by host. Default constructed point is
+/// considered to be always reached.
+struct SyncPoint {
+  const TimelineSemaphore *timeline = nullptr;
+  uint64_t value = 0u;
+
+  explicit operator bool() const { return timeline; }
+
+  /// @brief Checks if point is reached without blocking.
+  bool reached() const { return !timeline || timeline->value() >= value; }
+
+  /// @brief Blocks host until point is reached.
+  void wait() const {
+    if (timeline)
+      timeline->wait(value);
+  }
+};
+
+} // namespace imvk
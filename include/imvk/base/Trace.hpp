@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+/// @file
+/// Low overhead tracing of host side spans. Spans are recorded with
+/// IMVK_TRACE_SCOPE, which compiles to nothing unless IMVK_ENABLE_TRACING is
+/// defined (see CMake option of the same name).
+///
+/// Every thread writes into it's own lock-free single producer ring, so
+/// recording a span is two clock reads and a store. Rings are drained by
+/// dump() or by streaming thread started with startStreaming(). Spans that
+/// do not fit in a ring before it is drained are dropped and counted. Ring
+/// of exited thread is freed by the first drain after thread's exit.
+///
+/// Output is Chrome trace JSON. Timestamps are read from steady_clock.
+/// GpuProfiler maps device timestamps to the same clock once calibrated (see
+/// GpuProfiler::calibrate()). Host spans are written as process "cpu",
+/// GpuProfiler writes device scopes as process "gpu", so both traces may be
+/// merged into one view.
+
+namespace imvk::trace {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Returns timestamp spans are recorded with, in nanoseconds.
+inline uint64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+/// @brief Records span of calling thread.
+/// @param name name of span. Must have static storage duration.
+void record(const char *name, uint64_t begin, uint64_t end);
+
+/// @brief Names calling thread in trace.
+/// @param name name of thread. Must have static storage duration.
+void setThreadName(const char *name);
+
+/// @brief Drains rings of all threads and writes their spans as complete
+/// Chrome trace JSON.
+void dump(std::ostream &out);
+
+/// @brief Starts background thread that periodically drains rings of all
+/// threads into specified file. Trace is finalized by stopStreaming().
+/// Throws if file can not be opened or streaming is already started.
+void startStreaming(const std::filesystem::path &path,
+                    std::chrono::milliseconds period =
+                        std::chrono::milliseconds{10});
+
+/// @brief Drains remaining spans, finalizes trace file and stops streaming
+/// thread. No-op if streaming is not started. Must be called before program
+/// exits if streaming was started.
+void stopStreaming();
+
+/// @brief Returns number of spans dropped because rings were full.
+uint64_t droppedCount();
+
+class Scope final {
+public:
+  /// @class Scope
+  /// Records span covering lifetime of this object. Use IMVK_TRACE_SCOPE
+  /// instead of constructing it directly, so that tracing may be compiled
+  /// out.
+  explicit Scope(const char *name) : m_name(name), m_begin(now()) {}
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+  ~Scope() { record(m_name, m_begin, now()); }
+
+private:
+  const char *m_name;
+  uint64_t m_begin;
+};
+
+} // namespace imvk::trace
+
+#define IMVK_TRACE_CONCAT_IMPL(a, b) a##b
+#define IMVK_TRACE_CONCAT(a, b) IMVK_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef IMVK_ENABLE_TRACING
+#define IMVK_TRACE_SCOPE(name)                                                 \
+  ::imvk::trace::Scope IMVK_TRACE_CONCAT(imvkTraceScope, __LINE__) { name }
+#else
+#define IMVK_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
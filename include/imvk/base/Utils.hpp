@@ -1,9 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <ranges>
+#include <tuple>
 #include <vector>
 
 namespace imvk {
@@ -17,7 +24,6 @@ public:
 
   std::tuple<IT, Mapped &> emplace(auto &&...args) {
     auto index = m_getNextIndex();
-    m_freeList.pop_back();
     return {index, m_map[index].emplace(std::forward<decltype(args)>(args)...)};
   }
 
@@ -60,6 +66,8 @@ public:
   void clear() {
     m_map.clear();
     m_freeList.clear();
+    // dummy node.
+    m_map.emplace_back();
   }
 
 private:
@@ -73,7 +81,8 @@ private:
   }
   IT m_growOnce() {
     if (m_map.size() == m_map.capacity())
-      m_map.reserve(m_map.capacity() + m_reserveChunkSize);
+      m_map.reserve(std::max(m_map.capacity() * 2u,
+                             m_map.capacity() + m_reserveChunkSize));
 
     assert(m_map.size() < m_map.capacity());
     IT ret = m_map.size();
@@ -85,4 +94,184 @@ private:
   const size_t m_reserveChunkSize;
 };
 
+/// @brief LinearTable variant that keeps payloads densely packed. Ids stay
+/// stable while payloads are moved around: erase swaps last payload into the
+/// freed slot and patches id to index map. Freed ids are reused through a
+/// free list, same as in LinearTable, so emplace() and erase() take constant
+/// time. Occupancy of ids is tracked in a separate bitmap, so contains() does
+/// not touch the map, and iteration over items() touches payloads only.
+/// References returned by emplace() and at() are invalidated by emplace() and
+/// erase().
+template <std::integral IT, typename Mapped> class DenseLinearTable final {
+public:
+  DenseLinearTable(size_t reserveChunkSize)
+      : m_reserveChunkSize(reserveChunkSize) {
+    // id 0 is never handed out, same as in LinearTable.
+    m_sparse.push_back(0u);
+    m_occupancy.push_back(1u);
+  };
+
+  std::tuple<IT, Mapped &> emplace(auto &&...args) {
+    auto id = m_getNextId();
+    if (m_dense.size() == m_dense.capacity()) {
+      // Geometric growth keeps filling the table linear, chunk size only
+      // bounds the smallest step.
+      m_dense.reserve(std::max(m_dense.capacity() * 2u,
+                               m_dense.capacity() + m_reserveChunkSize));
+      m_ids.reserve(m_dense.capacity());
+    }
+    auto &ret = m_dense.emplace_back(std::forward<decltype(args)>(args)...);
+    m_ids.push_back(id);
+    m_sparse[id] = static_cast<IT>(m_dense.size() - 1u);
+    m_occupancy[id / 64u] |= uint64_t{1u} << (id % 64u);
+    return {id, ret};
+  }
+
+  bool contains(IT id) const {
+    return id && id / 64u < m_occupancy.size() &&
+           (m_occupancy[id / 64u] >> (id % 64u)) & 1u;
+  }
+
+  void erase(IT id) {
+    assert(contains(id));
+    auto index = m_sparse[id];
+    auto last = m_dense.size() - 1u;
+    if (index != last) {
+      m_dense[index] = std::move(m_dense[last]);
+      m_ids[index] = m_ids[last];
+      m_sparse[m_ids[index]] = index;
+    }
+    m_dense.pop_back();
+    m_ids.pop_back();
+    m_occupancy[id / 64u] &= ~(uint64_t{1u} << (id % 64u));
+    m_freeList.push_back(id);
+  }
+
+  Mapped &at(IT id) {
+    assert(contains(id));
+    return m_dense[m_sparse[id]];
+  }
+
+  const Mapped &at(IT id) const {
+    assert(contains(id));
+    return m_dense[m_sparse[id]];
+  }
+
+  size_t size() const { return m_dense.size(); }
+
+  auto items() {
+    return std::ranges::iota_view{size_t{0u}, m_dense.size()} |
+           std::views::transform([this](auto &&i) -> std::tuple<IT, Mapped &> {
+             return {m_ids[i], m_dense[i]};
+           });
+  }
+
+  auto items() const {
+    return std::ranges::iota_view{size_t{0u}, m_dense.size()} |
+           std::views::transform(
+               [this](auto &&i) -> std::tuple<IT, const Mapped &> {
+                 return {m_ids[i], m_dense[i]};
+               });
+  }
+
+  void clear() {
+    m_dense.clear();
+    m_ids.clear();
+    m_sparse.assign(1u, 0u);
+    m_freeList.clear();
+    m_occupancy.assign(1u, 1u);
+  }
+
+private:
+  IT m_getNextId() {
+    if (!m_freeList.empty()) {
+      auto id = m_freeList.back();
+      m_freeList.pop_back();
+      return id;
+    }
+    // Every id below m_sparse.size() has been handed out.
+    auto id = static_cast<IT>(m_sparse.size());
+    m_sparse.push_back(0u);
+    if (id / 64u == m_occupancy.size())
+      m_occupancy.push_back(0u);
+    return id;
+  }
+
+  std::vector<Mapped> m_dense;
+  std::vector<IT> m_ids;
+  std::vector<IT> m_sparse;
+  std::vector<IT> m_freeList;
+  std::vector<uint64_t> m_occupancy;
+  const size_t m_reserveChunkSize;
+};
+
+/// @brief Bounded lock-free multi-producer single-consumer ring.
+/// Any number of threads may push concurrently, only one thread may pop.
+/// Each cell carries a sequence number which tells whether it's ready to be
+/// written to or read from, so producers only contend on a single atomic
+/// counter and never block each other.
+template <typename T> class MPSCRing final {
+public:
+  /// @param capacity maximum number of elements. Rounded up to power of 2.
+  explicit MPSCRing(size_t capacity)
+      : m_mask(std::bit_ceil(std::max<size_t>(capacity, 2u)) - 1u),
+        m_cells(std::make_unique<Cell[]>(m_mask + 1u)) {
+    for (size_t i = 0; i <= m_mask; ++i)
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MPSCRing(const MPSCRing &) = delete;
+  MPSCRing &operator=(const MPSCRing &) = delete;
+
+  /// @brief Constructs element in ring. Never blocks.
+  /// @return false if ring is full.
+  bool tryPush(auto &&...args) {
+    auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &m_cells[pos & m_mask];
+      auto seq = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (m_enqueuePos.compare_exchange_weak(pos, pos + 1u,
+                                               std::memory_order_relaxed))
+          break;
+      } else if (diff < 0)
+        return false;
+      else
+        pos = m_enqueuePos.load(std::memory_order_relaxed);
+    }
+    cell->value.emplace(std::forward<decltype(args)>(args)...);
+    cell->sequence.store(pos + 1u, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Extracts oldest element. Must only be called by consumer thread.
+  /// @return nullopt if ring is empty.
+  std::optional<T> tryPop() {
+    auto &cell = m_cells[m_dequeuePos & m_mask];
+    auto seq = cell.sequence.load(std::memory_order_acquire);
+    if (seq != m_dequeuePos + 1u)
+      return std::nullopt;
+    std::optional<T> ret = std::move(cell.value);
+    cell.value.reset();
+    cell.sequence.store(m_dequeuePos + m_mask + 1u, std::memory_order_release);
+    ++m_dequeuePos;
+    return ret;
+  }
+
+  size_t capacity() const { return m_mask + 1u; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    std::optional<T> value;
+  };
+
+  const size_t m_mask;
+  std::unique_ptr<Cell[]> m_cells;
+  alignas(64) std::atomic<size_t> m_enqueuePos = 0u;
+  alignas(64) size_t m_dequeuePos = 0u;
+};
+
 } // namespace imvk
\ No newline at end of file
@@ -1,13 +1,96 @@
 #pragma once
 #include "imvk/base/Context.hpp"
+#include "imvk/base/EngineBase.hpp"
+
+#include "vkw/CommandBuffer.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
 
 namespace imvk {
 
-class ComputeEngine {
+class ComputeEngine : public EngineBase {
 public:
+  /// @class ComputeEngine
+  /// Executes batches of compute work independently of any frame-based
+  /// engine. Each batch is described by a job that records dispatches into
+  /// a command buffer. Jobs are recorded on engine's submission thread and
+  /// all batches pending at that moment are submitted with single
+  /// vkQueueSubmit call.
+  ///
+  /// Completion is tracked with engine's timeline semaphore - each batch
+  /// signals it's own sync point, so no fences are involved. Those points may
+  /// also be waited on by other engines on device.
+  ///
+  /// All methods are internally synchronized and may be called from any
+  /// thread.
+
+  using RecordJob = std::function<void(vkw::PrimaryCommandBuffer &)>;
+  using CompletionCallback = std::function<void(void)>;
+
+  struct Submission {
+    /// Becomes ready once batch is complete on device. If job throws -
+    /// exception is forwarded to this future.
+    std::shared_future<void> future;
+    /// Is reached once batch is complete on device.
+    SyncPoint syncPoint;
+  };
+
   ComputeEngine(ContextImpl &context, const ComputeEngineCreateInfo &CI);
 
+  /// @brief Schedules a batch of compute work. Waits requested by waitFor()
+  /// prior to this call are honored by this batch.
+  /// @param job callable recording commands of the batch. Command buffer is
+  /// already in recording state. Is invoked on engine's thread.
+  /// @param callback optional callable invoked on engine's thread once batch
+  /// is complete on device. It must not call into this engine.
+  /// @return completion future and sync point of the batch.
+  Submission enqueue(RecordJob job, CompletionCallback callback = nullptr);
+
+  /// @brief Returns sync point value of last batch whose completion was
+  /// observed by engine.
+  uint64_t completedValue() const;
+
+  ~ComputeEngine() override;
+
 private:
+  struct Job {
+    RecordJob record;
+    CompletionCallback callback;
+    std::promise<void> promise;
+    SyncPoint point;
+    SubmitBatch submitBatch;
+  };
+
+  struct Batch {
+    Batch(ComputeEngine &engine);
+    vkw::PrimaryCommandBuffer commands;
+    Job job;
+    std::shared_future<void> submitted;
+    bool failed = false;
+  };
+
+  void m_submitLoop();
+  void m_completionLoop();
+
+  uint64_t m_completedValue = 0;
+
+  std::vector<std::unique_ptr<Batch>> m_batches;
+  std::vector<Batch *> m_freeBatches;
+  std::deque<Job> m_pending;
+  std::deque<Batch *> m_inFlight;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_submitCv;
+  std::condition_variable m_completionCv;
+  bool m_stop = false;
+  bool m_submitDone = false;
+  std::thread m_submitThread;
+  std::thread m_completionThread;
 };
 
-} // namespace imvk
\ No newline at end of file
+} // namespace imvk
@@ -1,13 +1,145 @@
 #pragma once
 #include "imvk/base/Context.hpp"
+#include "imvk/base/EngineBase.hpp"
+#include "imvk/base/HostBuffer.hpp"
+
+#include "vkw/CommandBuffer.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
 
 namespace imvk {
 
-class CopyEngine {
+/// @brief Future of an upload scheduled on CopyEngine. Besides being waited
+/// on, it may run continuations once upload is complete, so it is a
+/// ContinuableFuture and COWPrimitive publishes uploaded objects without
+/// blocking executor's threads.
+class UploadFuture : public std::shared_future<void> {
 public:
+  UploadFuture() = default;
+
+  /// @brief Runs continuation once upload is complete: on copy engine's
+  /// thread, or in place if upload is complete already. Continuation must
+  /// not throw and must not wait for other uploads.
+  void then(std::function<void()> continuation) const;
+
+private:
+  friend class CopyEngine;
+
+  struct Continuations {
+    std::mutex mutex;
+    bool done = false;
+    std::vector<std::function<void()>> list;
+  };
+
+  UploadFuture(std::shared_future<void> future)
+      : std::shared_future<void>(std::move(future)),
+        m_continuations(std::make_shared<Continuations>()) {}
+
+  void m_runContinuations() const;
+
+  std::shared_ptr<Continuations> m_continuations;
+};
+
+class CopyEngine : public EngineBase {
+public:
+  /// @class CopyEngine
+  /// Uploads data to device local buffers and images asynchronously to other
+  /// engines. Data is first copied to persistently mapped staging ring buffer
+  /// and then transferred by copy commands. Copies are batched: all uploads
+  /// scheduled while previous batch is being executed on device are
+  /// recorded in the same command buffer and submitted at once.
+  ///
+  /// Every upload returns a future that becomes ready once the copy is
+  /// complete on device. This future is suitable to be returned as
+  /// initialization future from COWAllocator's 'allocate' method - objects
+  /// are then published by engine's thread right after upload completes.
+  /// Batches signal points on engine's timeline, so other engines may wait
+  /// for uploads on device instead - see flush() and lastSyncPoint().
+  ///
+  /// Destination resources must be accessible from engine's queue family -
+  /// either created with VK_SHARING_MODE_CONCURRENT or owned by that family.
+  ///
+  /// All methods are internally synchronized and may be called from any
+  /// thread.
+
   CopyEngine(ContextImpl &context, const CopyEngineCreateInfo &CI);
 
+  /// @brief Schedules copy of data to buffer region. Data is copied to staging
+  /// memory before return, so caller may release it right away. If staging
+  /// buffer is exhausted - blocks until earlier batches complete. Data larger
+  /// than staging buffer is split into several batches.
+  /// @param dst destination buffer.
+  /// @param dstOffset offset in destination buffer in bytes.
+  /// @param data data to upload.
+  /// @return future that becomes ready once copy is complete on device.
+  UploadFuture upload(VkBuffer dst, VkDeviceSize dstOffset,
+                      std::span<const std::byte> data);
+
+  /// @brief Schedules copy of data to image regions. Image is transitioned
+  /// from undefined layout into transfer destination layout before copy and
+  /// into final layout after. Previous contents of subresource range are
+  /// discarded. Data must fit in staging buffer.
+  /// @param dst destination image.
+  /// @param range subresource range that is being written.
+  /// @param finalLayout layout image is left in after copy.
+  /// @param regions copy regions. bufferOffset of each region is relative to
+  /// the beginning of data.
+  /// @param data data to upload.
+  /// @return future that becomes ready once copy is complete on device.
+  UploadFuture upload(VkImage dst, const VkImageSubresourceRange &range,
+                      VkImageLayout finalLayout,
+                      std::span<const VkBufferImageCopy> regions,
+                      std::span<const std::byte> data);
+
+  /// @brief Submits currently recorded batch without waiting for previous
+  /// batches to complete. Never blocks on device.
+  /// @return sync point that is reached once all uploads scheduled so far are
+  /// complete. It may be passed to waitFor() of any other engine.
+  SyncPoint flush();
+
+  ~CopyEngine() override;
+
 private:
+  struct Batch {
+    Batch(CopyEngine &engine);
+    vkw::PrimaryCommandBuffer commands;
+    SyncPoint point;
+    std::future<void> submitted;
+    std::promise<void> promise;
+    UploadFuture future;
+    uint64_t ringBegin = 0;
+    uint64_t ringEnd = 0;
+    size_t copyCount = 0;
+  };
+
+  Batch &m_reserve(std::unique_lock<std::mutex> &lock, VkDeviceSize size,
+                   VkDeviceSize &offset);
+  void m_submitRecording();
+  void m_completionLoop();
+
+  HostBuffer m_staging;
+  // Absolute positions in staging ring. Offset in buffer is position modulo
+  // buffer size.
+  uint64_t m_ringHead = 0;
+  uint64_t m_ringTail = 0;
+
+  std::vector<std::unique_ptr<Batch>> m_batches;
+  std::vector<Batch *> m_freeBatches;
+  Batch *m_recording = nullptr;
+  std::deque<Batch *> m_submitted;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop = false;
+  std::thread m_completionThread;
 };
 
-} // namespace imvk
\ No newline at end of file
+} // namespace imvk
@@ -0,0 +1,64 @@
+#pragma once
+#include "imvk/base/ResourceAllocators.hpp"
+#include "imvk/copy/Engine.hpp"
+
+#include <vector>
+
+namespace imvk {
+
+/// @brief COWAllocator for device local buffers. Contents are uploaded by
+/// copy engine, so reset() of primitive completes once upload is complete on
+/// device.
+/// Usage:
+///   COWPrimitive<Buffer, BufferUploadAllocator> mesh{engine, copyEngine, CI};
+///   auto allocated = mesh.reset(data);
+class BufferUploadAllocator {
+public:
+  /// @param copyEngine engine uploads are scheduled on.
+  /// @param CI create info of buffers. Size is taken from uploaded data.
+  /// Buffer must be accessible from copy engine's queue family (see
+  /// CopyEngine). TRANSFER_DST usage is added automatically.
+  BufferUploadAllocator(CopyEngine &copyEngine, const VkBufferCreateInfo &CI);
+
+  BufferUploadAllocator(const BufferUploadAllocator &another);
+
+  /// @param data initial contents of buffer. Is copied to staging memory
+  /// during this call. COWPrimitive::reset() calls it from the job and keeps
+  /// a copy of spans passed to it until then.
+  std::pair<std::shared_ptr<PrimitiveHandleImpl<Buffer>>, UploadFuture>
+  allocate(FramedEngine &engine, std::span<const std::byte> data) const;
+
+private:
+  CopyEngine &m_copyEngine;
+  VkBufferCreateInfo m_CI;
+  std::vector<uint32_t> m_queueFamilies;
+};
+
+/// @brief COWAllocator for sampled images. Contents are uploaded by copy
+/// engine and image is left in specified layout.
+class ImageUploadAllocator {
+public:
+  /// @param copyEngine engine uploads are scheduled on.
+  /// @param CI create info of images. Image must be accessible from copy
+  /// engine's queue family (see CopyEngine). TRANSFER_DST usage is added
+  /// automatically.
+  /// @param finalLayout layout image is left in after upload.
+  ImageUploadAllocator(CopyEngine &copyEngine, const VkImageCreateInfo &CI,
+                       VkImageLayout finalLayout);
+
+  ImageUploadAllocator(const ImageUploadAllocator &another);
+
+  /// @param regions copy regions, bufferOffset is relative to data.
+  /// @param data texel data.
+  std::pair<std::shared_ptr<PrimitiveHandleImpl<Image>>, UploadFuture>
+  allocate(FramedEngine &engine, std::span<const VkBufferImageCopy> regions,
+           std::span<const std::byte> data) const;
+
+private:
+  CopyEngine &m_copyEngine;
+  VkImageCreateInfo m_CI;
+  std::vector<uint32_t> m_queueFamilies;
+  VkImageLayout m_finalLayout;
+};
+
+} // namespace imvk
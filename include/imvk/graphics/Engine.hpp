@@ -2,20 +2,39 @@
 
 #include "imvk/base/Context.hpp"
 #include "imvk/base/EngineBase.hpp"
+#include "imvk/base/Trace.hpp"
 #include "imvk/graphics/Frame.hpp"
+#include "imvk/graphics/FramePacer.hpp"
 
 #include "vkw/CommandPool.hpp"
 #include "vkw/Fence.hpp"
 #include "vkw/Semaphore.hpp"
 
+#include <deque>
 #include <functional>
 
 namespace imvk {
 
-class Swapchain;
+class SwapchainBase;
 class FrameWithSync;
 class SwapFrame;
 
+/// @class GraphicsEngine
+/// Renders frames and presents them to swapchain. Each frame submission
+/// signals a sync point of engine's timeline, so lastSyncPoint() called
+/// within a frame scope refers to previous frame. Sync points passed to
+/// waitFor() are waited on by next frame submission.
+///
+/// Swapchain is recreated without stalling device: retiring swapchain is
+/// handed to the new one as oldSwapchain and is destroyed once frames that
+/// used it are complete. Resources that depend on swapchain should be
+/// released the same way using deferDestruction().
+///
+/// Without swapchain factory engine runs headless: frames render to a ring
+/// of offscreen images, acquire and present are skipped.
+///
+/// Frames in flight and start time of each frame are driven by FramePacer
+/// according to GraphicsEngineCreateInfo::pacingMode.
 class GraphicsEngine : public FramedEngine {
 private:
   struct Terminator {
@@ -34,33 +53,70 @@ public:
 
   void run(auto &&frameJob, auto &&interFrameJob) {
     std::unique_ptr<GraphicsEngine, Terminator> terminatorGuard{this};
-    while (std::invoke(interFrameJob)) {
+    for (;;) {
+      {
+        IMVK_TRACE_SCOPE("FramePacer::sleep");
+        m_pacer.sleep();
+      }
+      {
+        IMVK_TRACE_SCOPE("GraphicsEngine::interFrameJob");
+        if (!std::invoke(interFrameJob))
+          break;
+      }
       auto frame = m_beginFrame();
       if (!frame)
         continue;
-      std::invoke(frameJob, *frame);
+      {
+        IMVK_TRACE_SCOPE("GraphicsEngine::frameJob");
+        std::invoke(frameJob, *frame);
+      }
       m_endFrame();
     }
   }
 
-  const Swapchain &swapchain() const { return *m_swapchain; }
+  /// @brief Returns images frames render to. In headless mode it is an
+  /// OffscreenSwapchain, otherwise it is a Swapchain.
+  const SwapchainBase &swapchain() const { return *m_swapchain; }
+
+  /// @brief Returns true if engine renders without a surface.
+  bool headless() const { return !m_swapchainFactory; }
+
+  /// @brief Returns timings frame pacing is currently based on.
+  FramePacingStatistics pacingStatistics() const {
+    return m_pacer.statistics();
+  }
+
+  /// @brief Keeps object alive until device completes all frames that may
+  /// use it: frames submitted so far and, if called within frame scope, the
+  /// current one. Object is destroyed on engine's thread at the beginning of
+  /// one of the following frames.
+  void deferDestruction(auto &&object) {
+    m_deferDestruction(std::make_shared<std::decay_t<decltype(object)>>(
+        std::forward<decltype(object)>(object)));
+  }
 
   ~GraphicsEngine() override;
 
 private:
   void m_recreate_swapchain();
+  void m_deferDestruction(std::shared_ptr<void> object);
+  void m_collectGarbage();
   bool m_surface_minimized();
   void m_terminate();
 
   std::optional<SwapFrame> m_beginFrame();
+  SwapFrame m_beginAndGetCurrentFrame();
   void m_endFrame();
 
-  SwapchainFactory &m_swapchainFactory;
-  std::unique_ptr<Swapchain> m_swapchain;
+  SwapchainFactory *m_swapchainFactory;
+  std::unique_ptr<SwapchainBase> m_swapchain;
+  FramePacer m_pacer;
   std::vector<FrameSyncObjects> m_frameSyncs;
   std::optional<SwapFrame> m_currentFrame;
+  bool m_recreatePending = false;
+  std::deque<std::pair<SyncPoint, std::shared_ptr<void>>> m_deferred;
   std::vector<std::pair<std::function<void(void)>,
-                        std::function<void(const Swapchain &)>>>
+                        std::function<void(const SwapchainBase &)>>>
       m_swapChainCallbacks;
 };
 
@@ -3,14 +3,17 @@
 #include "vkw/Fence.hpp"
 #include "vkw/Semaphore.hpp"
 
+#include <chrono>
+#include <future>
+
 namespace imvk {
 
 class GraphicsEngine;
-class Swapchain;
+class SwapchainBase;
 
 class SwapFrame {
 public:
-  SwapFrame(const Frame &frame, const Swapchain &swapchain)
+  SwapFrame(const Frame &frame, const SwapchainBase &swapchain)
       : m_frame(frame), m_swapchain(swapchain){};
 
   const auto &frame() const { return m_frame.get(); }
@@ -19,7 +22,7 @@ public:
 
 private:
   std::reference_wrapper<const Frame> m_frame;
-  std::reference_wrapper<const Swapchain> m_swapchain;
+  std::reference_wrapper<const SwapchainBase> m_swapchain;
 };
 
 class FrameSyncObjects final {
@@ -28,7 +31,11 @@ public:
   vkw::Semaphore renderComplete, presentComplete;
   bool needFenceWait = false;
   vkw::Fence fence;
-  void waitIfNeeded();
+  /// Completion of submission and presentation handed to the queue.
+  std::future<void> submission, presentation;
+  /// @brief Waits for previous submission of this frame if there is one.
+  /// @return time host was blocked on the fence.
+  std::chrono::steady_clock::duration waitIfNeeded();
 };
 
 } // namespace imvk
\ No newline at end of file
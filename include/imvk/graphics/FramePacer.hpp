@@ -0,0 +1,87 @@
+#pragma once
+
+#include "imvk/base/Context.hpp"
+
+#include <chrono>
+
+namespace imvk {
+
+struct FramePacingStatistics {
+  /// Smoothed time host spends recording a frame.
+  std::chrono::nanoseconds recordTime;
+  /// Smoothed time host spends blocked on fence of a frame in flight.
+  std::chrono::nanoseconds fenceWaitTime;
+  /// Time host was blocked on fence before the last frame.
+  std::chrono::nanoseconds lastFenceWaitTime;
+  /// Smoothed interval between successive presents.
+  std::chrono::nanoseconds presentInterval;
+  /// Time host currently sleeps before starting each frame.
+  std::chrono::nanoseconds sleepTime;
+  /// Frames in flight currently used by engine.
+  unsigned framesInFlight;
+};
+
+class FramePacer final {
+public:
+  /// @class FramePacer
+  /// Decides how many frames engine keeps in flight and when each frame is
+  /// started, based on timings measured by engine.
+  ///
+  /// In latency mode host time that would be spent blocked on a fence is
+  /// spent sleeping before the frame instead, so input sampled between frames
+  /// is as fresh as possible. Sleep is driven by integral controller that
+  /// keeps fence wait slightly above zero. Frames in flight are kept at two
+  /// and are raised whenever device is starved (present interval spikes),
+  /// then gradually lowered back once pacing is stable again.
+  ///
+  /// In throughput mode all frames in flight are used and no pacing sleep is
+  /// done. Frame rate limiter works in both modes.
+  ///
+  /// Not thread safe - meant to be driven by engine's thread only.
+
+  using Clock = std::chrono::steady_clock;
+
+  /// @param mode pacing policy.
+  /// @param maxFramesInFlight frames in flight engine has resources for.
+  /// @param maxFrameRate frame rate limit, 0 for no limit.
+  FramePacer(FramePacingMode mode, unsigned maxFramesInFlight,
+             float maxFrameRate);
+
+  /// @brief Blocks until next frame should be started. Must be called once
+  /// per loop iteration before frame inputs are sampled.
+  void sleep();
+
+  /// @brief Reports time host was blocked on fence of a frame in flight.
+  void fenceWaited(Clock::duration duration);
+
+  /// @brief Reports that frame recording has started.
+  void recordStarted() { m_recordStart = Clock::now(); }
+
+  /// @brief Reports that frame is recorded and handed over for presentation.
+  void presented();
+
+  /// @brief Returns frames in flight engine should use for next frame.
+  unsigned framesInFlight() const { return m_framesInFlight; }
+
+  FramePacingStatistics statistics() const;
+
+private:
+  void m_adaptFramesInFlight(Clock::duration interval);
+
+  const FramePacingMode m_mode;
+  const unsigned m_maxFramesInFlight;
+  const Clock::duration m_limiterPeriod;
+
+  unsigned m_framesInFlight;
+  Clock::time_point m_recordStart;
+  Clock::time_point m_lastPresent;
+  Clock::time_point m_nextFrame;
+  Clock::duration m_sleepTime{};
+  Clock::duration m_recordTime{};
+  Clock::duration m_fenceWaitTime{};
+  Clock::duration m_presentInterval{};
+  Clock::duration m_lastFenceWait{};
+  unsigned m_stableFrames = 0u;
+};
+
+} // namespace imvk
@@ -1,26 +1,146 @@
 #pragma once
 
+#include "imvk/base/Resource.hpp"
+#include "imvk/base/ResourceStateTracker.hpp"
+
 #include "vkw/Image.hpp"
 #include "vkw/SwapChain.hpp"
 
-#include "imvk/base/Queue.hpp"
-
+#include <memory>
 #include <span>
 #include <vector>
 
 namespace imvk {
 
-class Swapchain : public vkw::SwapChain {
+class SwapchainBase {
+public:
+  /// @class SwapchainBase
+  /// Set of color images GraphicsEngine frames render to. Each frame renders
+  /// to currentImage(). Images are in layout() between frames - frames must
+  /// leave them in it.
+
+  /// @brief Returns views of all images, indexed same way as currentImage().
+  virtual std::span<const VkImageView> attachments() const = 0;
+
+  /// @brief Returns image with specified index.
+  virtual VkImage image(uint32_t index) const = 0;
+
+  /// @brief Returns index of image current frame renders to.
+  virtual uint32_t currentImage() const = 0;
+
+  virtual VkFormat format() const = 0;
+
+  virtual VkExtent2D extent() const = 0;
+
+  /// @brief Returns layout images are kept in between frames.
+  virtual VkImageLayout layout() const = 0;
+
+  /// @brief Starts tracking current image in frame's resource states. If no
+  /// frame has used that image yet, requires it's transition out of
+  /// UNDEFINED layout into layout(). Pending barrier must be flushed before
+  /// any other command that accesses the image.
+  void trackCurrentImage(ResourceStateTracker &states);
+
+  virtual ~SwapchainBase() = default;
+
+protected:
+  /// @brief Must be called by implementation once image count is known.
+  void m_resetInitialTransitions(size_t imageCount) {
+    m_needsInitialTransition.assign(imageCount, true);
+  }
+
+private:
+  std::vector<bool> m_needsInitialTransition;
+};
+
+class Swapchain : public vkw::SwapChain, public SwapchainBase {
 public:
-  Swapchain(vkw::Device &device, Queue &queue,
-            const VkSwapchainCreateInfoKHR &CI);
+  /// @class Swapchain
+  /// Images of presentable swapchain.
+
+  /// @param oldSwapchain swapchain being replaced, or null handle. It is
+  /// retired by this call, but must be kept alive until device is done with
+  /// frames that used it.
+  Swapchain(vkw::Device &device, const VkSwapchainCreateInfoKHR &CI,
+            VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
+
+  std::span<const VkImageView> attachments() const override {
+    return m_attachments;
+  }
+
+  VkImage image(uint32_t index) const override;
+
+  uint32_t currentImage() const override {
+    return vkw::SwapChain::currentImage();
+  }
+
+  VkFormat format() const override { return m_format; }
+
+  VkExtent2D extent() const override { return m_extent; }
 
-  std::span<const vkw::ImageView<vkw::COLOR, vkw::V2DA>> attachments() const {
-    return m_image_views;
+  VkImageLayout layout() const override {
+    return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
   }
 
 private:
+  VkFormat m_format;
+  VkExtent2D m_extent;
   std::vector<vkw::ImageView<vkw::COLOR, vkw::V2DA>> m_image_views;
+  std::vector<VkImageView> m_attachments;
+};
+
+class OffscreenSwapchain final : public SwapchainBase {
+public:
+  /// @class OffscreenSwapchain
+  /// Ring of color images for rendering without a surface. Each frame takes
+  /// the next image of the ring, nothing is presented. To stay valid, ring
+  /// must be at least as long as number of frames in flight.
+
+  /// @param allocator allocator images are created with.
+  /// @param imageCount number of images in ring.
+  /// @param format format of images.
+  /// @param extent extent of images.
+  /// @param usage usage of images in addition to color attachment.
+  OffscreenSwapchain(DeviceAllocator &allocator, unsigned imageCount,
+                     VkFormat format, VkExtent2D extent,
+                     VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                               VK_IMAGE_USAGE_SAMPLED_BIT);
+
+  OffscreenSwapchain(const OffscreenSwapchain &) = delete;
+  OffscreenSwapchain &operator=(const OffscreenSwapchain &) = delete;
+
+  /// @brief Moves to the next image of the ring.
+  void acquireNextImage() {
+    m_currentImage = (m_currentImage + 1u) % m_images.size();
+  }
+
+  std::span<const VkImageView> attachments() const override {
+    return m_attachments;
+  }
+
+  VkImage image(uint32_t index) const override {
+    return m_images.at(index)->handle();
+  }
+
+  uint32_t currentImage() const override { return m_currentImage; }
+
+  VkFormat format() const override { return m_format; }
+
+  VkExtent2D extent() const override { return m_extent; }
+
+  VkImageLayout layout() const override {
+    return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  }
+
+  ~OffscreenSwapchain() override;
+
+private:
+  vkw::Device &m_device;
+  VkFormat m_format;
+  VkExtent2D m_extent;
+  std::vector<std::unique_ptr<Image>> m_images;
+  std::vector<VkImageView> m_attachments;
+  uint32_t m_currentImage = 0u;
 };
 
-} // namespace imvk
\ No newline at end of file
+} // namespace imvk
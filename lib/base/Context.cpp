@@ -17,14 +17,22 @@ Context::createGraphicsEngine(const GraphicsEngineCreateInfo &CI) {
 
 EngineHandle<ComputeEngine>
 Context::createComputeEngine(const ComputeEngineCreateInfo &CI) {
-  // TODO
-  return nullptr;
+  return std::make_unique<ComputeEngine>(*m_pimpl, CI);
 }
 
 EngineHandle<CopyEngine>
 Context::createCopyEngine(const CopyEngineCreateInfo &CI) {
-  // TODO
-  return nullptr;
+  return std::make_unique<CopyEngine>(*m_pimpl, CI);
+}
+
+SubmitStatistics Context::submitStatistics() const {
+  return m_pimpl->submitStatistics();
+}
+
+void Context::savePipelineCache() { m_pimpl->pipelineCache().save(); }
+
+DeviceAllocatorStatistics Context::deviceAllocatorStatistics() const {
+  return m_pimpl->deviceAllocator().statistics();
 }
 
 } // namespace imvk
\ No newline at end of file
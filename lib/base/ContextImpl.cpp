@@ -7,7 +7,13 @@
 namespace imvk {
 
 ContextImpl::ContextImpl(const ContextCreateInfo &CI)
-    : m_device(CI.device), m_shaderFactory(CI.shaderFactory) {
+    : m_device(CI.device), m_shaderFactory(CI.shaderFactory),
+      m_threadedSubmission(CI.threadedSubmission),
+      m_submitCoalescingWindow(CI.submitCoalescingWindow),
+      m_pipelineCache(CI.device, CI.pipelineCachePath),
+      m_deviceAllocator(CI.device, CI.deviceMemoryBlockSize),
+      m_threadPool(CI.executor ? nullptr : std::make_unique<ThreadPool>()),
+      m_executor(CI.executor ? *CI.executor : *m_threadPool) {
   // pre-initialize queue map
   for (auto &&index : m_device.physicalDevice().queueFamilies() |
                           std::views::transform(
@@ -31,8 +37,8 @@ Queue &ContextImpl::allocateQueue(const QueueCapsInfo &queueInfo) {
   };
   auto viableMatch = [&](auto &&family) {
     return (!queueInfo.graphics || family.graphics()) &&
-           (!queueInfo.compute == family.compute()) &&
-           (!queueInfo.transfer == family.transfer());
+           (!queueInfo.compute || family.compute()) &&
+           (!queueInfo.transfer || family.transfer());
   };
 
   auto tryAllocateNew = [&](auto &&queueFamily) -> Queue * {
@@ -101,20 +107,54 @@ Queue &ContextImpl::allocateQueue(const QueueCapsInfo &queueInfo) {
 }
 
 void ContextImpl::freeQueue(Queue &queue) {
-  auto handedQueue = queue.acquire();
-  auto &queueRef = handedQueue.get();
-  auto queueIndex = queueRef.index();
-  auto familyIndex = queueRef.family().index();
+  unsigned queueIndex, familyIndex;
+  {
+    auto handedQueue = queue.acquire();
+    queueIndex = handedQueue.get().index();
+    familyIndex = handedQueue.get().family().index();
+  }
   auto &queueMap = m_queueMap.at(familyIndex);
 
   auto &[pQueue, refCount] = queueMap.at(queueIndex);
   assert(pQueue == &queue);
+  --refCount;
   if (refCount == 0) {
+    auto *pErased = pQueue;
     queueMap.erase(queueIndex);
-    m_queueStorage.erase(pQueue);
+    m_queueStorage.erase(pErased);
     return;
   }
-  --refCount;
+  if (refCount == 1u)
+    pQueue->giveUpLock();
+}
+
+SubmitStatistics ContextImpl::submitStatistics() const {
+  SubmitStatistics ret{};
+  for (auto &&[pQueue, queue] : m_queueStorage) {
+    auto stats = queue->statistics();
+    ret.batches += stats.batches;
+    ret.submitCalls += stats.submitCalls;
+  }
+  return ret;
+}
+
+TimelineSemaphore &ContextImpl::allocateTimeline() {
+  if (!m_freeTimelines.empty()) {
+    auto *timeline = m_freeTimelines.back();
+    m_freeTimelines.pop_back();
+    return *timeline;
+  }
+  return *m_timelines.emplace_back(
+      std::make_unique<TimelineSemaphore>(m_device));
+}
+
+void ContextImpl::freeTimeline(TimelineSemaphore &timeline,
+                               uint64_t lastValue) {
+  // Next engine continues from current value, which must cover every point
+  // handed out so far.
+  if (timeline.value() < lastValue)
+    timeline.signal(lastValue);
+  m_freeTimelines.push_back(&timeline);
 }
 
 Queue &ContextImpl::m_allocateQueue(unsigned queueFamilyIndex,
@@ -122,13 +162,18 @@ Queue &ContextImpl::m_allocateQueue(unsigned queueFamilyIndex,
   auto &queueMap = m_queueMap.at(queueFamilyIndex);
   if (queueMap.contains(queueIndex)) {
     auto &[pQueue, refCount] = queueMap.at(queueIndex);
-    if (refCount == 1u)
-      pQueue->introduceLock();
+    if (refCount == 1u) {
+      if (m_threadedSubmission)
+        pQueue->introduceSubmitThread();
+      else
+        pQueue->introduceLock();
+    }
     ++refCount;
     return *pQueue;
   }
-  auto pQueue = new Queue{m_device.getQueue(queueFamilyIndex, queueIndex),
-                          /* sync */ false};
+  auto pQueue = new Queue{m_device,
+                          m_device.getQueue(queueFamilyIndex, queueIndex),
+                          /* sync */ false, m_submitCoalescingWindow};
   m_queueStorage.emplace(pQueue, pQueue);
   queueMap.emplace(std::piecewise_construct, std::make_tuple(queueIndex),
                    std::make_tuple(pQueue, 1u));
@@ -0,0 +1,363 @@
+#include "imvk/base/DeviceAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <ranges>
+#include <stdexcept>
+
+namespace imvk {
+
+namespace {
+
+constexpr VkDeviceSize defaultBlockSize = 64u * 1024u * 1024u;
+
+struct UsageFlags {
+  VkMemoryPropertyFlags required;
+  VkMemoryPropertyFlags preferred;
+  VkMemoryPropertyFlags avoided;
+};
+
+UsageFlags usageFlags(MemoryUsage usage) {
+  switch (usage) {
+  case MemoryUsage::device:
+    return {VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT};
+  case MemoryUsage::upload:
+    return {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT};
+  case MemoryUsage::dynamic:
+    return {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            0};
+  case MemoryUsage::readback:
+    return {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+            VK_MEMORY_PROPERTY_HOST_CACHED_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            0};
+  }
+  return {};
+}
+
+} // namespace
+
+DeviceAllocation::DeviceAllocation(DeviceAllocation &&another) noexcept
+    : m_allocator(std::exchange(another.m_allocator, nullptr)),
+      m_block(another.m_block), m_handle(another.m_handle),
+      m_memory(another.m_memory), m_offset(another.m_offset),
+      m_size(another.m_size), m_mapped(another.m_mapped),
+      m_memoryType(another.m_memoryType), m_coherent(another.m_coherent) {}
+
+DeviceAllocation &
+DeviceAllocation::operator=(DeviceAllocation &&another) noexcept {
+  if (this == &another)
+    return *this;
+  if (m_allocator)
+    m_allocator->m_free(*this);
+  m_allocator = std::exchange(another.m_allocator, nullptr);
+  m_block = another.m_block;
+  m_handle = another.m_handle;
+  m_memory = another.m_memory;
+  m_offset = another.m_offset;
+  m_size = another.m_size;
+  m_mapped = another.m_mapped;
+  m_memoryType = another.m_memoryType;
+  m_coherent = another.m_coherent;
+  return *this;
+}
+
+void DeviceAllocation::flush(VkDeviceSize offset, VkDeviceSize size) const {
+  if (m_coherent || !m_mapped)
+    return;
+  auto atom = m_allocator->m_atomSize;
+  // Non-coherent allocations are aligned to nonCoherentAtomSize, so rounded
+  // range never leaves it.
+  VkMappedMemoryRange range{};
+  range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+  range.memory = m_memory;
+  range.offset = (m_offset + offset) / atom * atom;
+  range.size = std::min((m_offset + offset + size + atom - 1u) / atom * atom,
+                        m_offset + m_size) -
+               range.offset;
+  auto &device = m_allocator->m_device;
+  device.core<1, 0>().vkFlushMappedMemoryRanges(device, 1, &range);
+}
+
+void DeviceAllocation::invalidate(VkDeviceSize offset,
+                                  VkDeviceSize size) const {
+  if (m_coherent || !m_mapped)
+    return;
+  auto atom = m_allocator->m_atomSize;
+  VkMappedMemoryRange range{};
+  range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+  range.memory = m_memory;
+  range.offset = (m_offset + offset) / atom * atom;
+  range.size = std::min((m_offset + offset + size + atom - 1u) / atom * atom,
+                        m_offset + m_size) -
+               range.offset;
+  auto &device = m_allocator->m_device;
+  device.core<1, 0>().vkInvalidateMappedMemoryRanges(device, 1, &range);
+}
+
+DeviceAllocation::~DeviceAllocation() {
+  if (m_allocator)
+    m_allocator->m_free(*this);
+}
+
+DeviceAllocator::DeviceAllocator(vkw::Device &device, VkDeviceSize blockSize)
+    : m_device(device) {
+  auto &instanceCore = m_device.parent().core<1, 0>();
+  instanceCore.vkGetPhysicalDeviceMemoryProperties(m_device.physicalDevice(),
+                                                   &m_memoryProperties);
+  VkPhysicalDeviceProperties properties;
+  instanceCore.vkGetPhysicalDeviceProperties(m_device.physicalDevice(),
+                                             &properties);
+  m_atomSize = properties.limits.nonCoherentAtomSize;
+  m_blockSize = blockSize ? blockSize : defaultBlockSize;
+}
+
+DeviceAllocation DeviceAllocator::allocate(VkBuffer buffer,
+                                           MemoryUsage usage) {
+  VkBufferMemoryRequirementsInfo2 info{};
+  info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+  info.buffer = buffer;
+  VkMemoryDedicatedRequirements dedicated{};
+  dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+  VkMemoryRequirements2 requirements{};
+  requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+  requirements.pNext = &dedicated;
+  m_device.core<1, 1>().vkGetBufferMemoryRequirements2(m_device, &info,
+                                                       &requirements);
+
+  auto ret = m_allocate(requirements.memoryRequirements, usage, true,
+                        dedicated.prefersDedicatedAllocation ||
+                            dedicated.requiresDedicatedAllocation,
+                        buffer, VK_NULL_HANDLE);
+  if (m_device.core<1, 0>().vkBindBufferMemory(m_device, buffer, ret.memory(),
+                                               ret.offset()) != VK_SUCCESS)
+    throw std::runtime_error("Failed to bind buffer memory.");
+  return ret;
+}
+
+DeviceAllocation DeviceAllocator::allocate(VkImage image, bool linear,
+                                           MemoryUsage usage) {
+  VkImageMemoryRequirementsInfo2 info{};
+  info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+  info.image = image;
+  VkMemoryDedicatedRequirements dedicated{};
+  dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+  VkMemoryRequirements2 requirements{};
+  requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+  requirements.pNext = &dedicated;
+  m_device.core<1, 1>().vkGetImageMemoryRequirements2(m_device, &info,
+                                                      &requirements);
+
+  auto ret = m_allocate(requirements.memoryRequirements, usage, linear,
+                        dedicated.prefersDedicatedAllocation ||
+                            dedicated.requiresDedicatedAllocation,
+                        VK_NULL_HANDLE, image);
+  if (m_device.core<1, 0>().vkBindImageMemory(m_device, image, ret.memory(),
+                                              ret.offset()) != VK_SUCCESS)
+    throw std::runtime_error("Failed to bind image memory.");
+  return ret;
+}
+
+DeviceAllocation
+DeviceAllocator::allocate(const VkMemoryRequirements &requirements,
+                          MemoryUsage usage, bool linear, bool dedicated) {
+  return m_allocate(requirements, usage, linear, dedicated, VK_NULL_HANDLE,
+                    VK_NULL_HANDLE);
+}
+
+DeviceAllocatorStatistics DeviceAllocator::statistics() const {
+  return {m_deviceMemoryCount.load(std::memory_order_relaxed),
+          m_allocationCount.load(std::memory_order_relaxed),
+          m_reservedBytes.load(std::memory_order_relaxed),
+          m_usedBytes.load(std::memory_order_relaxed)};
+}
+
+DeviceAllocator::~DeviceAllocator() {
+  for (auto &pool : m_pools)
+    for (auto &block : pool.blocks)
+      m_freeMemory(block->memory, block->heap.size());
+}
+
+DeviceAllocation DeviceAllocator::m_allocate(
+    const VkMemoryRequirements &requirements, MemoryUsage usage, bool linear,
+    bool dedicated, VkBuffer dedicatedBuffer, VkImage dedicatedImage) {
+  // Resources that would occupy large part of block only fragment it.
+  dedicated = dedicated || requirements.size > m_blockSize / 2u;
+
+  DeviceAllocation ret;
+  ret.m_allocator = this;
+  ret.m_size = requirements.size;
+
+  for (auto type : m_candidateTypes(requirements.memoryTypeBits, usage)) {
+    ret.m_memoryType = type;
+    ret.m_coherent = m_isCoherent(type);
+
+    if (dedicated) {
+      ret.m_memory = m_allocateMemory(type, requirements.size, dedicatedBuffer,
+                                      dedicatedImage, ret.m_mapped);
+      if (!ret.m_memory)
+        continue;
+      ret.m_block = nullptr;
+      ret.m_offset = 0u;
+      m_allocationCount.fetch_add(1u, std::memory_order_relaxed);
+      m_usedBytes.fetch_add(ret.m_size, std::memory_order_relaxed);
+      return ret;
+    }
+
+    // Flushes of non-coherent memory operate on whole atoms, so allocations
+    // must not share them.
+    auto alignment = ret.m_coherent
+                         ? requirements.alignment
+                         : std::max(requirements.alignment, m_atomSize);
+    auto size = ret.m_coherent ? requirements.size
+                               : (requirements.size + m_atomSize - 1u) /
+                                     m_atomSize * m_atomSize;
+
+    auto poolIndex = type * 2u + (linear ? 0u : 1u);
+    auto &pool = m_pools[poolIndex];
+    auto lock = std::unique_lock{pool.mutex};
+
+    auto place = [&](Block &block) {
+      auto placed = block.heap.allocate(size, alignment);
+      if (!placed)
+        return false;
+      ret.m_block = &block;
+      ret.m_handle = placed->handle;
+      ret.m_size = size;
+      ret.m_memory = block.memory;
+      ret.m_offset = placed->offset;
+      ret.m_mapped = block.mapped ? block.mapped + placed->offset : nullptr;
+      return true;
+    };
+
+    // Newest blocks are tried first - older ones are more fragmented.
+    auto placed = std::ranges::any_of(
+        pool.blocks | std::views::reverse,
+        [&](auto &block) { return place(*block); });
+    if (!placed) {
+      auto block = std::make_unique<Block>(m_blockSize);
+      block->pool = poolIndex;
+      block->memory = m_allocateMemory(type, m_blockSize, VK_NULL_HANDLE,
+                                       VK_NULL_HANDLE, block->mapped);
+      if (!block->memory)
+        continue;
+      placed = place(*block);
+      assert(placed);
+      pool.blocks.push_back(std::move(block));
+    }
+    m_allocationCount.fetch_add(1u, std::memory_order_relaxed);
+    m_usedBytes.fetch_add(ret.m_size, std::memory_order_relaxed);
+    return ret;
+  }
+
+  ret.m_allocator = nullptr;
+  throw std::runtime_error(
+      "Failed to allocate device memory - no suitable memory type has enough "
+      "free space.");
+}
+
+std::vector<uint32_t>
+DeviceAllocator::m_candidateTypes(uint32_t typeBits, MemoryUsage usage) const {
+  auto flags = usageFlags(usage);
+  std::vector<std::pair<int, uint32_t>> scored;
+  for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i) {
+    auto typeFlags = m_memoryProperties.memoryTypes[i].propertyFlags;
+    if (!(typeBits & (1u << i)) ||
+        (typeFlags & flags.required) != flags.required)
+      continue;
+    auto score = std::popcount(typeFlags & flags.preferred) -
+                 std::popcount(typeFlags & flags.avoided);
+    scored.emplace_back(score, i);
+  }
+  std::ranges::stable_sort(scored, std::ranges::greater{},
+                           [](auto &&pair) { return pair.first; });
+  std::vector<uint32_t> ret;
+  std::ranges::transform(scored, std::back_inserter(ret),
+                         [](auto &&pair) { return pair.second; });
+  return ret;
+}
+
+VkDeviceMemory DeviceAllocator::m_allocateMemory(uint32_t memoryType,
+                                                 VkDeviceSize size,
+                                                 VkBuffer dedicatedBuffer,
+                                                 VkImage dedicatedImage,
+                                                 std::byte *&mapped) {
+  auto &core = m_device.core<1, 0>();
+
+  VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+  dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+  dedicatedInfo.buffer = dedicatedBuffer;
+  dedicatedInfo.image = dedicatedImage;
+
+  VkMemoryAllocateInfo allocateInfo{};
+  allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocateInfo.allocationSize = size;
+  allocateInfo.memoryTypeIndex = memoryType;
+  if (dedicatedBuffer || dedicatedImage)
+    allocateInfo.pNext = &dedicatedInfo;
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  if (core.vkAllocateMemory(m_device, &allocateInfo, nullptr, &memory) !=
+      VK_SUCCESS)
+    return VK_NULL_HANDLE;
+
+  mapped = nullptr;
+  if (m_memoryProperties.memoryTypes[memoryType].propertyFlags &
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+    void *pData = nullptr;
+    if (core.vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, &pData) !=
+        VK_SUCCESS) {
+      core.vkFreeMemory(m_device, memory, nullptr);
+      return VK_NULL_HANDLE;
+    }
+    mapped = static_cast<std::byte *>(pData);
+  }
+
+  m_deviceMemoryCount.fetch_add(1u, std::memory_order_relaxed);
+  m_reservedBytes.fetch_add(size, std::memory_order_relaxed);
+  return memory;
+}
+
+void DeviceAllocator::m_freeMemory(VkDeviceMemory memory, VkDeviceSize size) {
+  // Memory is implicitly unmapped when freed.
+  m_device.core<1, 0>().vkFreeMemory(m_device, memory, nullptr);
+  m_deviceMemoryCount.fetch_sub(1u, std::memory_order_relaxed);
+  m_reservedBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void DeviceAllocator::m_free(DeviceAllocation &allocation) {
+  m_allocationCount.fetch_sub(1u, std::memory_order_relaxed);
+  m_usedBytes.fetch_sub(allocation.m_size, std::memory_order_relaxed);
+
+  if (!allocation.m_block) {
+    m_freeMemory(allocation.m_memory, allocation.m_size);
+    return;
+  }
+
+  auto *block = static_cast<Block *>(allocation.m_block);
+  auto &pool = m_pools[block->pool];
+  auto lock = std::unique_lock{pool.mutex};
+  block->heap.free(allocation.m_handle);
+  // Keep last block of pool around, so that single resource being recreated
+  // does not allocate and free memory each time.
+  if (!block->heap.empty() || pool.blocks.size() == 1u)
+    return;
+  auto found = std::ranges::find_if(
+      pool.blocks, [&](auto &&pBlock) { return pBlock.get() == block; });
+  assert(found != pool.blocks.end());
+  m_freeMemory(block->memory, block->heap.size());
+  pool.blocks.erase(found);
+}
+
+bool DeviceAllocator::m_isCoherent(uint32_t memoryType) const {
+  return m_memoryProperties.memoryTypes[memoryType].propertyFlags &
+         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+} // namespace imvk
@@ -1,12 +1,50 @@
 #include "imvk/base/EngineBase.hpp"
 #include "imvk/base/Frame.hpp"
+#include "imvk/base/Trace.hpp"
+
+#include <algorithm>
 
 namespace imvk {
 
+namespace {
+
+constexpr VkDeviceSize defaultTransientBufferSize = 4u * 1024u * 1024u;
+
+} // namespace
+
+void EngineBase::waitFor(const SyncPoint &point, VkPipelineStageFlags stages) {
+  if (!point || point.timeline == &m_timeline)
+    return;
+  auto lock = std::unique_lock{m_waitsMutex};
+  // Timeline values are monotonic - keep only the latest point per timeline.
+  auto found = std::ranges::find_if(m_pendingWaits, [&](auto &&wait) {
+    return wait.first.timeline == point.timeline;
+  });
+  if (found == m_pendingWaits.end()) {
+    m_pendingWaits.emplace_back(point, stages);
+    return;
+  }
+  found->first.value = std::max(found->first.value, point.value);
+  found->second |= stages;
+}
+
+void EngineBase::consumeWaits(SubmitBatch &batch) {
+  auto lock = std::unique_lock{m_waitsMutex};
+  for (auto &&[point, stages] : m_pendingWaits)
+    batch.addWait(point, stages);
+  m_pendingWaits.clear();
+}
+
 FramedEngine::FramedEngine(ContextImpl &ctx, const QueueCapsInfo &queueInfo,
-                           unsigned frameInFlightCount)
+                           unsigned frameInFlightCount,
+                           VkDeviceSize transientBufferSize,
+                           unsigned gpuScopesPerFrame)
     : EngineBase(ctx, queueInfo), m_frameInFlightCount(frameInFlightCount),
+      m_transientBufferSize(transientBufferSize ? transientBufferSize
+                                                : defaultTransientBufferSize),
+      m_gpuProfiler(ctx.device(), queueFamilyIndex(), gpuScopesPerFrame),
       m_dynamicFIFCount(frameInFlightCount) {
+  m_gpuProfiler.calibrate(queue(), commandPool());
   m_frames.reserve(frameInFlightCount);
   std::ranges::transform(std::ranges::iota_view{0u, frameInFlightCount},
                          std::back_inserter(m_frames), [this](auto &&i) {
@@ -16,17 +54,20 @@ FramedEngine::FramedEngine(ContextImpl &ctx, const QueueCapsInfo &queueInfo,
 
 void FramedEngine::setDynamicFIFCount(unsigned count) {
   assert(count <= m_frameInFlightCount);
-  m_dynamicFIFCount = m_frameInFlightCount;
+  assert(count);
+  m_dynamicFIFCount = count;
   if (m_currentFrame >= m_dynamicFIFCount)
     m_currentFrame = 0u;
 }
 
 void FramedEngine::endAndAdvanceFrame() {
+  IMVK_TRACE_SCOPE("FramedEngine::endAndAdvanceFrame");
   m_frames.at(m_currentFrame)->end();
   m_currentFrame = (m_currentFrame + 1u) % m_dynamicFIFCount;
 }
 
 const Frame &FramedEngine::beginAndGetCurrentFrame() const {
+  IMVK_TRACE_SCOPE("FramedEngine::beginAndGetCurrentFrame");
   Frame &frame = *m_frames.at(m_currentFrame);
   frame.begin();
   return frame;
@@ -0,0 +1,90 @@
+#include "imvk/base/Executor.hpp"
+
+#include <algorithm>
+
+namespace imvk {
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+  if (!threadCount)
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  std::ranges::generate_n(std::back_inserter(m_workers), threadCount,
+                          []() { return std::make_unique<Worker>(); });
+  for (unsigned i = 0; i < threadCount; ++i)
+    m_workers[i]->thread = std::thread{[this, i]() { m_loop(i); }};
+}
+
+void ThreadPool::post(std::shared_ptr<Job> job) {
+  auto &worker =
+      *m_workers[m_next.fetch_add(1u, std::memory_order_relaxed) %
+                 m_workers.size()];
+  {
+    auto lock = std::unique_lock{worker.mutex};
+    worker.jobs.push_back(std::move(job));
+    m_pending.fetch_add(1u);
+  }
+  // Owner of the queue may be busy - any idle worker steals the job. Either
+  // this load observes a worker going idle, or that worker observes the job.
+  if (m_idle.load()) {
+    {
+      auto lock = std::unique_lock{m_idleMutex};
+    }
+    m_idleCv.notify_one();
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    auto lock = std::unique_lock{m_idleMutex};
+    m_stop = true;
+  }
+  m_idleCv.notify_all();
+  for (auto &worker : m_workers)
+    worker->thread.join();
+}
+
+void ThreadPool::m_loop(unsigned index) {
+  auto &worker = *m_workers[index];
+  for (;;) {
+    auto job = m_pop(worker, false);
+    if (!job)
+      job = m_steal(index);
+    if (job) {
+      job->run();
+      continue;
+    }
+
+    auto lock = std::unique_lock{m_idleMutex};
+    m_idle.fetch_add(1u);
+    m_idleCv.wait(lock, [&]() { return m_pending.load() || m_stop; });
+    m_idle.fetch_sub(1u);
+    if (!m_pending.load())
+      return;
+  }
+}
+
+std::shared_ptr<Job> ThreadPool::m_pop(Worker &worker, bool back) {
+  auto lock = std::unique_lock{worker.mutex};
+  if (worker.jobs.empty())
+    return nullptr;
+  std::shared_ptr<Job> job;
+  if (back) {
+    job = std::move(worker.jobs.back());
+    worker.jobs.pop_back();
+  } else {
+    job = std::move(worker.jobs.front());
+    worker.jobs.pop_front();
+  }
+  m_pending.fetch_sub(1u);
+  return job;
+}
+
+std::shared_ptr<Job> ThreadPool::m_steal(unsigned index) {
+  for (unsigned i = 1; i < m_workers.size(); ++i) {
+    // Steal from the back - the front is what victim is about to take.
+    if (auto job = m_pop(*m_workers[(index + i) % m_workers.size()], true))
+      return job;
+  }
+  return nullptr;
+}
+
+} // namespace imvk
@@ -1,49 +1,137 @@
 #include "imvk/base/Frame.hpp"
 #include "imvk/base/Primitive.hpp"
+#include "imvk/base/Trace.hpp"
+
+#include <stdexcept>
 
 namespace imvk {
 
+void FrameFork::join() {
+  // vkCmdExecuteCommands requires at least one buffer.
+  if (m_commands.empty())
+    return;
+  auto &core = m_frame.engine().context().device().core<1, 0>();
+  for (auto commands : m_commands)
+    if (core.vkEndCommandBuffer(commands) != VK_SUCCESS)
+      throw std::runtime_error("Failed to end secondary command buffer.");
+  core.vkCmdExecuteCommands(m_frame.commands(), m_commands.size(),
+                            m_commands.data());
+  m_commands.clear();
+}
+
 Frame::Frame(FramedEngine &engine, unsigned id)
     : m_engine(engine), m_id(id), m_commandBuffer(engine.commandPool()),
-      m_registeredPrimitives(100) {}
+      m_transientAllocator(engine.context().device(),
+                           engine.getTransientBufferSize()),
+      m_profiler(engine.context().device(), engine.gpuProfiler()),
+      m_primitives(id),
+      m_resourceStates(engine.context().device(), m_commandBuffer) {}
 
 void Frame::begin() {
-  // garbage collect primitives
-  m_toBeDeleted.clear();
-  for (auto &&[i, pair] : m_registeredPrimitives.items()) {
-    auto &&[pPrim, used] = pair;
-    if (used) {
-      used = false;
-      continue;
-    }
-    pPrim->setIDforFrame(id(), 0u);
-    m_toBeDeleted.emplace_back(i);
+  IMVK_TRACE_SCOPE("Frame::begin");
+  // Device is done with previous use of this frame - release primitives
+  // that were not used during it. Timestamps of that use are read back in
+  // m_profiler.begin() for the same reason.
+  {
+    IMVK_TRACE_SCOPE("PrimitiveTracker::beginEpoch");
+    m_primitives.beginEpoch();
   }
 
-  for (auto &&i : m_toBeDeleted)
-    m_registeredPrimitives.erase(i);
+  m_transientAllocator.reset();
+  m_resourceStates.reset();
+
+  auto &device = m_engine.context().device();
+  for (auto &pool : m_secondaryPools) {
+    if (!pool.used)
+      continue;
+    device.core<1, 0>().vkResetCommandPool(device, pool.pool, 0);
+    pool.used = 0u;
+  }
 
   m_commandBuffer.reset(0);
   m_commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+  m_profiler.begin(m_commandBuffer);
 }
 
 void Frame::usePrimitive(
-    const std::shared_ptr<PrimitiveHandleBase> &primitive) {
-  auto &prim = *primitive;
-  if (!prim.getIDforFrame(id())) {
-    auto &&[index, pair] = m_registeredPrimitives.emplace();
-    prim.setIDforFrame(id(), index);
-    pair.first = primitive;
-    pair.second = true;
-    return;
+    const std::shared_ptr<PrimitiveHandleBase> &primitive) const {
+  m_primitives.use(primitive);
+}
+
+void Frame::end() {
+  IMVK_TRACE_SCOPE("Frame::end");
+  m_transientAllocator.flush();
+  m_resourceStates.flush();
+  m_commandBuffer.end();
+}
+FrameFork
+Frame::fork(unsigned count,
+            const VkCommandBufferInheritanceInfo *inheritance) const {
+  auto &device = m_engine.context().device();
+  auto &core = device.core<1, 0>();
+
+  while (m_secondaryPools.size() < count)
+    m_secondaryPools.emplace_back(device, m_engine.queueFamilyIndex());
+
+  VkCommandBufferInheritanceInfo noInheritance{};
+  noInheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if (inheritance && inheritance->renderPass)
+    beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+  beginInfo.pInheritanceInfo = inheritance ? inheritance : &noInheritance;
+
+  std::vector<VkCommandBuffer> commands;
+  commands.reserve(count);
+  for (unsigned i = 0; i < count; ++i) {
+    auto &pool = m_secondaryPools[i];
+    // Buffers are kept between frames and reused after pool reset.
+    if (pool.used == pool.commands.size()) {
+      VkCommandBufferAllocateInfo allocateInfo{};
+      allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+      allocateInfo.commandPool = pool.pool;
+      allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+      allocateInfo.commandBufferCount = 1u;
+      VkCommandBuffer buffer;
+      if (core.vkAllocateCommandBuffers(device, &allocateInfo, &buffer) !=
+          VK_SUCCESS)
+        throw std::runtime_error(
+            "Failed to allocate secondary command buffer.");
+      pool.commands.push_back(buffer);
+    }
+    auto buffer = pool.commands[pool.used++];
+    if (core.vkBeginCommandBuffer(buffer, &beginInfo) != VK_SUCCESS)
+      throw std::runtime_error("Failed to begin secondary command buffer.");
+    commands.push_back(buffer);
+  }
+  return FrameFork{*this, std::move(commands)};
+}
+
+void Frame::recordParallel(
+    Executor &executor, unsigned count, const RecordJob &job,
+    const VkCommandBufferInheritanceInfo *inheritance) const {
+  auto frameFork = fork(count, inheritance);
+  std::vector<Completion> completions;
+  completions.reserve(count);
+  for (unsigned i = 0; i < count; ++i)
+    completions.push_back(post(executor, [&job, i, &frameFork]() {
+      std::invoke(job, i, frameFork.commands(i));
+    }));
+
+  std::exception_ptr error;
+  for (auto &completion : completions) {
+    try {
+      completion.get();
+    } catch (...) {
+      if (!error)
+        error = std::current_exception();
+    }
   }
-  auto index = prim.getIDforFrame(id());
-  assert(m_registeredPrimitives.contains(index));
-  auto &&[pPrim, used] = m_registeredPrimitives.at(index);
-  assert(pPrim == primitive);
-  used = true;
+  frameFork.join();
+  if (error)
+    std::rethrow_exception(error);
 }
 
-void Frame::end() { m_commandBuffer.end(); }
 Frame::~Frame() = default;
 } // namespace imvk
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "imvk/base/GpuProfiler.hpp"
+#include "imvk/base/Queue.hpp"
+#include "imvk/base/Trace.hpp"
+
+#include "vkw/CommandBuffer.hpp"
+#include "vkw/Fence.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace imvk {
+
+namespace {
+
+void writeEscaped(std::ostream &out, std::string_view str) {
+  for (auto c : str) {
+    if (c == '"' || c == '\\')
+      out << '\\';
+    out << c;
+  }
+}
+
+constexpr unsigned calibrationAttempts = 8u;
+
+} // namespace
+
+GpuProfiler::GpuProfiler(vkw::Device &device, unsigned queueFamilyIndex,
+                         unsigned scopesPerFrame, size_t traceCapacity)
+    : m_device(device), m_scopesPerFrame(scopesPerFrame),
+      m_traceCapacity(traceCapacity) {
+  auto &instanceCore = device.parent().core<1, 0>();
+  VkPhysicalDeviceProperties properties;
+  instanceCore.vkGetPhysicalDeviceProperties(device.physicalDevice(),
+                                             &properties);
+  m_timestampPeriod = properties.limits.timestampPeriod;
+
+  uint32_t familyCount = 0u;
+  instanceCore.vkGetPhysicalDeviceQueueFamilyProperties(
+      device.physicalDevice(), &familyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> families(familyCount);
+  instanceCore.vkGetPhysicalDeviceQueueFamilyProperties(
+      device.physicalDevice(), &familyCount, families.data());
+  auto validBits = families.at(queueFamilyIndex).timestampValidBits;
+  if (!validBits)
+    m_scopesPerFrame = 0u;
+  m_timestampMask = validBits >= 64u ? ~0ull : (1ull << validBits) - 1u;
+}
+
+void GpuProfiler::calibrate(const Queue &queue,
+                            vkw::CommandPool &commandPool) {
+  if (!enabled())
+    return;
+
+  auto &core = m_device.core<1, 0>();
+  VkQueryPoolCreateInfo poolCI{};
+  poolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  poolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  poolCI.queryCount = 1u;
+  VkQueryPool pool;
+  if (core.vkCreateQueryPool(m_device, &poolCI, nullptr, &pool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create timestamp query pool.");
+
+  vkw::PrimaryCommandBuffer commands{commandPool};
+  vkw::Fence fence{m_device};
+  uint64_t bestWindow = ~0ull;
+  uint64_t origin = 0u;
+  uint64_t hostOrigin = 0u;
+  try {
+    for (unsigned i = 0; i < calibrationAttempts; ++i) {
+      commands.reset(0);
+      commands.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+      core.vkCmdResetQueryPool(commands, pool, 0u, 1u);
+      core.vkCmdWriteTimestamp(commands, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                               pool, 0u);
+      commands.end();
+
+      SubmitBatch batch;
+      batch.addCommandBuffer(commands);
+      auto before = trace::now();
+      queue.submit(std::move(batch), fence).get();
+      fence.wait();
+      auto after = trace::now();
+      fence.reset();
+
+      uint64_t ticks;
+      if (core.vkGetQueryPoolResults(m_device, pool, 0u, 1u, sizeof(ticks),
+                                     &ticks, sizeof(ticks),
+                                     VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+        continue;
+      // Timestamp is written somewhere between the two host reads, the
+      // narrower the window the closer midpoint is to it.
+      if (after - before < bestWindow) {
+        bestWindow = after - before;
+        origin = ticks;
+        hostOrigin = before + (after - before) / 2u;
+      }
+    }
+  } catch (...) {
+    core.vkDestroyQueryPool(m_device, pool, nullptr);
+    throw;
+  }
+  core.vkDestroyQueryPool(m_device, pool, nullptr);
+
+  if (bestWindow == ~0ull)
+    return;
+  auto lock = std::unique_lock{m_mutex};
+  m_origin = origin;
+  m_hostOrigin = hostOrigin;
+  m_calibrated = true;
+}
+
+void GpuProfiler::collect(std::span<const ScopeRecord> scopes) {
+  auto lock = std::unique_lock{m_mutex};
+  if (!m_calibrated && !m_frameCount && !scopes.empty())
+    m_origin = scopes.front().begin;
+  auto frame = m_frameCount++;
+
+  for (auto &record : scopes) {
+    // Masked difference handles counter wrap around.
+    auto ticks = (record.end - record.begin) & m_timestampMask;
+    auto duration = static_cast<double>(ticks) * m_timestampPeriod * 1e-6;
+
+    auto found = m_scopes.find(record.name);
+    if (found == m_scopes.end())
+      found = m_scopes.emplace(std::string{record.name}, Scope{}).first;
+    auto &scope = found->second;
+    if (scope.window.size() < windowSize)
+      scope.window.push_back(duration);
+    else
+      scope.window[scope.count % windowSize] = duration;
+    scope.last = duration;
+    ++scope.count;
+
+    // Trace keeps names by view - they point to keys of scope map.
+    auto begin = (record.begin - m_origin) & m_timestampMask;
+    m_trace.push_back(TraceEvent{
+        found->first, frame, record.depth,
+        (static_cast<double>(m_hostOrigin) +
+         static_cast<double>(begin) * m_timestampPeriod) *
+            1e-3,
+        duration * 1e3});
+    if (m_trace.size() > m_traceCapacity)
+      m_trace.pop_front();
+  }
+}
+
+std::vector<GpuScopeStatistics> GpuProfiler::statistics() const {
+  auto lock = std::unique_lock{m_mutex};
+  std::vector<GpuScopeStatistics> ret;
+  ret.reserve(m_scopes.size());
+  for (auto &[name, scope] : m_scopes) {
+    auto [min, max] = std::ranges::minmax(scope.window);
+    auto sum = std::accumulate(scope.window.begin(), scope.window.end(), 0.0);
+    ret.push_back(GpuScopeStatistics{name, scope.count, scope.last,
+                                     sum / scope.window.size(), min, max});
+  }
+  return ret;
+}
+
+void GpuProfiler::writeChromeTrace(std::ostream &out) const {
+  auto lock = std::unique_lock{m_mutex};
+  // Timestamps are in microseconds of host time domain, default precision
+  // would round them.
+  auto flags = out.flags();
+  auto precision = out.precision(3);
+  out.setf(std::ios::fixed, std::ios::floatfield);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (auto &event : m_trace) {
+    if (!first)
+      out << ',';
+    first = false;
+    out << "{\"name\":\"";
+    writeEscaped(out, event.name);
+    // Device timeline is shown as a separate process, nesting is preserved
+    // by complete events of the same thread.
+    out << "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":\"gpu\",\"tid\":0,"
+        << "\"ts\":" << event.begin << ",\"dur\":" << event.duration
+        << ",\"args\":{\"frame\":" << event.frame
+        << ",\"depth\":" << event.depth << "}}";
+  }
+  out << "]}";
+  out.flags(flags);
+  out.precision(precision);
+}
+
+FrameProfiler::FrameProfiler(vkw::Device &device, GpuProfiler &profiler)
+    : m_device(device), m_profiler(profiler) {
+  if (!m_profiler.enabled())
+    return;
+
+  VkQueryPoolCreateInfo poolCI{};
+  poolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  poolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  poolCI.queryCount = 2u * m_profiler.scopesPerFrame();
+  if (device.core<1, 0>().vkCreateQueryPool(device, &poolCI, nullptr,
+                                            &m_pool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create timestamp query pool.");
+  m_scopes.reserve(m_profiler.scopesPerFrame());
+  m_results.resize(poolCI.queryCount);
+}
+
+void FrameProfiler::begin(VkCommandBuffer commands) {
+  if (!m_pool)
+    return;
+
+  auto &core = m_device.core<1, 0>();
+  if (!m_scopes.empty()) {
+    auto queryCount = 2u * static_cast<uint32_t>(m_scopes.size());
+    // Device is done with the frame, so results are available and this never
+    // blocks. Frame whose scopes were not all closed is dropped.
+    auto result = core.vkGetQueryPoolResults(
+        m_device, m_pool, 0u, queryCount, queryCount * sizeof(uint64_t),
+        m_results.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result == VK_SUCCESS) {
+      for (size_t i = 0; i < m_scopes.size(); ++i) {
+        m_scopes[i].begin = m_results[2u * i];
+        m_scopes[i].end = m_results[2u * i + 1u];
+      }
+      m_profiler.collect(m_scopes);
+    }
+  }
+  m_scopes.clear();
+  m_depth = 0u;
+
+  core.vkCmdResetQueryPool(commands, m_pool, 0u,
+                           2u * m_profiler.scopesPerFrame());
+}
+
+unsigned FrameProfiler::beginScope(VkCommandBuffer commands,
+                                   std::string_view name) {
+  if (!m_pool || m_scopes.size() == m_profiler.scopesPerFrame())
+    return ~0u;
+
+  unsigned index = m_scopes.size();
+  m_scopes.push_back(GpuProfiler::ScopeRecord{name, m_depth++, 0u, 0u});
+  m_device.core<1, 0>().vkCmdWriteTimestamp(
+      commands, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_pool, 2u * index);
+  return index;
+}
+
+void FrameProfiler::endScope(VkCommandBuffer commands, unsigned index) {
+  if (index == ~0u)
+    return;
+
+  --m_depth;
+  m_device.core<1, 0>().vkCmdWriteTimestamp(
+      commands, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_pool, 2u * index + 1u);
+}
+
+FrameProfiler::~FrameProfiler() {
+  if (m_pool)
+    m_device.core<1, 0>().vkDestroyQueryPool(m_device, m_pool, nullptr);
+}
+
+} // namespace imvk
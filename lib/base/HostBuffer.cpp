@@ -0,0 +1,104 @@
+#include "imvk/base/HostBuffer.hpp"
+
+#include <stdexcept>
+
+namespace imvk {
+
+namespace {
+
+unsigned findHostMemoryType(const VkPhysicalDeviceMemoryProperties &props,
+                            uint32_t typeBits, bool &coherent) {
+  constexpr auto preferred = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  for (auto pass : {preferred, VkMemoryPropertyFlags{
+                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT}}) {
+    for (unsigned i = 0; i < props.memoryTypeCount; ++i) {
+      if (!(typeBits & (1u << i)))
+        continue;
+      auto flags = props.memoryTypes[i].propertyFlags;
+      if ((flags & pass) == pass) {
+        coherent = flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        return i;
+      }
+    }
+  }
+  throw std::runtime_error(
+      "Failed to allocate host buffer - no host visible memory type found.");
+}
+
+} // namespace
+
+HostBuffer::HostBuffer(vkw::Device &device, VkDeviceSize size,
+                       VkBufferUsageFlags usage)
+    : m_device(device), m_size(size) {
+  auto &core = m_device.core<1, 0>();
+
+  VkBufferCreateInfo bufferCI{};
+  bufferCI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferCI.size = size;
+  bufferCI.usage = usage;
+  bufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  if (core.vkCreateBuffer(m_device, &bufferCI, nullptr, &m_buffer) !=
+      VK_SUCCESS)
+    throw std::runtime_error("Failed to create host buffer.");
+
+  VkMemoryRequirements requirements;
+  core.vkGetBufferMemoryRequirements(m_device, m_buffer, &requirements);
+
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  m_device.parent().core<1, 0>().vkGetPhysicalDeviceMemoryProperties(
+      m_device.physicalDevice(), &memoryProperties);
+
+  VkPhysicalDeviceProperties deviceProperties;
+  m_device.parent().core<1, 0>().vkGetPhysicalDeviceProperties(
+      m_device.physicalDevice(), &deviceProperties);
+  m_atomSize = deviceProperties.limits.nonCoherentAtomSize;
+  m_allocationSize = requirements.size;
+
+  VkMemoryAllocateInfo allocateInfo{};
+  allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocateInfo.allocationSize = requirements.size;
+  allocateInfo.memoryTypeIndex = findHostMemoryType(
+      memoryProperties, requirements.memoryTypeBits, m_coherent);
+
+  if (core.vkAllocateMemory(m_device, &allocateInfo, nullptr, &m_memory) !=
+      VK_SUCCESS) {
+    core.vkDestroyBuffer(m_device, m_buffer, nullptr);
+    throw std::runtime_error("Failed to allocate host buffer memory.");
+  }
+
+  core.vkBindBufferMemory(m_device, m_buffer, m_memory, 0);
+
+  void *mapped = nullptr;
+  if (core.vkMapMemory(m_device, m_memory, 0, VK_WHOLE_SIZE, 0, &mapped) !=
+      VK_SUCCESS) {
+    core.vkDestroyBuffer(m_device, m_buffer, nullptr);
+    core.vkFreeMemory(m_device, m_memory, nullptr);
+    throw std::runtime_error("Failed to map host buffer memory.");
+  }
+  m_mapped = static_cast<std::byte *>(mapped);
+}
+
+void HostBuffer::flush(VkDeviceSize offset, VkDeviceSize size) const {
+  if (m_coherent)
+    return;
+  // Range must be aligned to nonCoherentAtomSize.
+  auto begin = offset / m_atomSize * m_atomSize;
+  auto end = (offset + size + m_atomSize - 1u) / m_atomSize * m_atomSize;
+  VkMappedMemoryRange range{};
+  range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+  range.memory = m_memory;
+  range.offset = begin;
+  range.size = end >= m_allocationSize ? VK_WHOLE_SIZE : end - begin;
+  m_device.core<1, 0>().vkFlushMappedMemoryRanges(m_device, 1, &range);
+}
+
+HostBuffer::~HostBuffer() {
+  auto &core = m_device.core<1, 0>();
+  core.vkUnmapMemory(m_device, m_memory);
+  core.vkDestroyBuffer(m_device, m_buffer, nullptr);
+  core.vkFreeMemory(m_device, m_memory, nullptr);
+}
+
+} // namespace imvk
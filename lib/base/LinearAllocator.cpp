@@ -0,0 +1,38 @@
+#include "imvk/base/LinearAllocator.hpp"
+
+#include <bit>
+#include <cassert>
+#include <stdexcept>
+
+namespace imvk {
+
+LinearAllocator::LinearAllocator(vkw::Device &device, VkDeviceSize size,
+                                 VkBufferUsageFlags usage)
+    : m_buffer(device, size, usage) {
+  VkPhysicalDeviceProperties properties;
+  device.parent().core<1, 0>().vkGetPhysicalDeviceProperties(
+      device.physicalDevice(), &properties);
+  m_defaultAlignment = properties.limits.minUniformBufferOffsetAlignment;
+}
+
+TransientAllocation LinearAllocator::allocate(VkDeviceSize size,
+                                              VkDeviceSize alignment) {
+  if (!alignment)
+    alignment = m_defaultAlignment;
+  assert(std::has_single_bit(alignment));
+
+  auto head = m_head.load(std::memory_order_relaxed);
+  VkDeviceSize offset;
+  do {
+    offset = (head + alignment - 1u) & ~(alignment - 1u);
+    if (offset + size > m_buffer.size())
+      throw std::runtime_error(
+          "Failed to allocate transient data - linear allocator is out of "
+          "space.");
+  } while (!m_head.compare_exchange_weak(head, offset + size,
+                                         std::memory_order_relaxed));
+
+  return {m_buffer.mapped().subspan(offset, size), m_buffer.buffer(), offset};
+}
+
+} // namespace imvk
@@ -0,0 +1,207 @@
+#include "imvk/base/PipelineCache.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+
+namespace imvk {
+
+namespace {
+
+constexpr char fileMagic[8] = {'I', 'M', 'V', 'K', 'P', 'C', 'C', 'H'};
+constexpr uint32_t fileVersion = 1u;
+
+uint64_t checksum(std::span<const char> data) {
+  // FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (auto c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+} // namespace
+
+struct PipelineCache::FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t vendorID;
+  uint32_t deviceID;
+  uint32_t driverVersion;
+  uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+  uint8_t deviceUUID[VK_UUID_SIZE];
+  uint64_t dataSize;
+  uint64_t checksum;
+};
+
+PipelineCache::PipelineCache(vkw::Device &device, std::filesystem::path path)
+    : m_device(device), m_path(std::move(path)) {
+  VkPhysicalDeviceIDProperties idProperties{};
+  idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+  VkPhysicalDeviceProperties2 properties{};
+  properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties.pNext = &idProperties;
+  m_device.parent().core<1, 1>().vkGetPhysicalDeviceProperties2(
+      m_device.physicalDevice(), &properties);
+
+  m_vendorID = properties.properties.vendorID;
+  m_deviceID = properties.properties.deviceID;
+  m_driverVersion = properties.properties.driverVersion;
+  std::memcpy(m_pipelineCacheUUID, properties.properties.pipelineCacheUUID,
+              VK_UUID_SIZE);
+  std::memcpy(m_deviceUUID, idProperties.deviceUUID, VK_UUID_SIZE);
+
+  auto initialData = m_load();
+  VkPipelineCacheCreateInfo CI{};
+  CI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  CI.initialDataSize = initialData.size();
+  CI.pInitialData = initialData.data();
+  if (m_device.core<1, 0>().vkCreatePipelineCache(m_device, &CI, nullptr,
+                                                  &m_cache) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create pipeline cache.");
+}
+
+VkPipelineCache PipelineCache::createEngineCache() {
+  auto lock = std::unique_lock{m_mutex};
+  auto initialData = m_getData(m_cache);
+  VkPipelineCacheCreateInfo CI{};
+  CI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  CI.initialDataSize = initialData.size();
+  CI.pInitialData = initialData.data();
+  VkPipelineCache ret;
+  if (m_device.core<1, 0>().vkCreatePipelineCache(m_device, &CI, nullptr,
+                                                  &ret) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create engine pipeline cache.");
+  m_engineCaches.push_back(ret);
+  return ret;
+}
+
+void PipelineCache::releaseEngineCache(VkPipelineCache cache) {
+  auto lock = std::unique_lock{m_mutex};
+  auto found = std::ranges::find(m_engineCaches, cache);
+  assert(found != m_engineCaches.end());
+  m_engineCaches.erase(found);
+  auto &core = m_device.core<1, 0>();
+  core.vkMergePipelineCaches(m_device, m_cache, 1u, &cache);
+  core.vkDestroyPipelineCache(m_device, cache, nullptr);
+}
+
+void PipelineCache::save() {
+  auto lock = std::unique_lock{m_mutex};
+  m_mergeEngineCaches();
+  if (m_path.empty())
+    return;
+
+  auto data = m_getData(m_cache);
+  auto header = m_header();
+  header.dataSize = data.size();
+  header.checksum = checksum(data);
+
+  if (m_path.has_parent_path())
+    std::filesystem::create_directories(m_path.parent_path());
+
+  // Write to temporary file first, so that cache file is never observed
+  // partially written - even if application crashes during save.
+  auto tmpPath = m_path;
+  tmpPath += ".tmp";
+  {
+    std::ofstream os{tmpPath, std::ios::binary | std::ios::trunc};
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(data.data(), data.size());
+    os.flush();
+    if (!os)
+      throw std::runtime_error("Failed to write pipeline cache file: " +
+                               tmpPath.string());
+  }
+  std::filesystem::rename(tmpPath, m_path);
+}
+
+PipelineCache::~PipelineCache() {
+  assert(m_engineCaches.empty());
+  try {
+    save();
+  } catch (...) {
+    // Failing to persist the cache only costs time on next start.
+  }
+  m_device.core<1, 0>().vkDestroyPipelineCache(m_device, m_cache, nullptr);
+}
+
+PipelineCache::FileHeader PipelineCache::m_header() const {
+  FileHeader ret{};
+  std::memcpy(ret.magic, fileMagic, sizeof(fileMagic));
+  ret.version = fileVersion;
+  ret.vendorID = m_vendorID;
+  ret.deviceID = m_deviceID;
+  ret.driverVersion = m_driverVersion;
+  std::memcpy(ret.pipelineCacheUUID, m_pipelineCacheUUID, VK_UUID_SIZE);
+  std::memcpy(ret.deviceUUID, m_deviceUUID, VK_UUID_SIZE);
+  return ret;
+}
+
+std::vector<char> PipelineCache::m_load() const {
+  std::error_code ec;
+  if (m_path.empty() || !std::filesystem::is_regular_file(m_path, ec))
+    return {};
+  auto fileSize = std::filesystem::file_size(m_path, ec);
+  if (ec || fileSize < sizeof(FileHeader))
+    return {};
+
+  std::ifstream is{m_path, std::ios::binary};
+  FileHeader header;
+  if (!is.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    return {};
+
+  // Validate imvk header.
+  auto expected = m_header();
+  if (std::memcmp(header.magic, expected.magic, sizeof(fileMagic)) ||
+      header.version != expected.version ||
+      header.vendorID != expected.vendorID ||
+      header.deviceID != expected.deviceID ||
+      header.driverVersion != expected.driverVersion ||
+      std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID,
+                  VK_UUID_SIZE) ||
+      std::memcmp(header.deviceUUID, expected.deviceUUID, VK_UUID_SIZE) ||
+      header.dataSize != fileSize - sizeof(FileHeader))
+    return {};
+
+  std::vector<char> data(header.dataSize);
+  if (!is.read(data.data(), data.size()) || checksum(data) != header.checksum)
+    return {};
+
+  // Validate vulkan header as well - driver is not obliged to do that.
+  VkPipelineCacheHeaderVersionOne vkHeader;
+  if (data.size() < sizeof(vkHeader))
+    return {};
+  std::memcpy(&vkHeader, data.data(), sizeof(vkHeader));
+  if (vkHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+      vkHeader.vendorID != m_vendorID || vkHeader.deviceID != m_deviceID ||
+      std::memcmp(vkHeader.pipelineCacheUUID, m_pipelineCacheUUID,
+                  VK_UUID_SIZE))
+    return {};
+
+  return data;
+}
+
+std::vector<char> PipelineCache::m_getData(VkPipelineCache cache) const {
+  auto &core = m_device.core<1, 0>();
+  size_t size = 0;
+  core.vkGetPipelineCacheData(m_device, cache, &size, nullptr);
+  std::vector<char> ret(size);
+  if (size)
+    core.vkGetPipelineCacheData(m_device, cache, &size, ret.data());
+  ret.resize(size);
+  return ret;
+}
+
+void PipelineCache::m_mergeEngineCaches() {
+  if (m_engineCaches.empty())
+    return;
+  m_device.core<1, 0>().vkMergePipelineCaches(
+      m_device, m_cache, m_engineCaches.size(), m_engineCaches.data());
+}
+
+} // namespace imvk
@@ -0,0 +1,76 @@
+#include "imvk/base/PrimitiveTracker.hpp"
+#include "imvk/base/Primitive.hpp"
+
+namespace imvk {
+
+PrimitiveTracker::PrimitiveTracker(unsigned frameId, size_t reserveChunkSize)
+    : m_frameId(frameId), m_entries(reserveChunkSize) {}
+
+void PrimitiveTracker::beginEpoch() {
+  ++m_epoch;
+  while (m_head) {
+    auto index = m_head;
+    auto &entry = m_entries.at(index);
+    if (entry.epoch + 1u >= m_epoch)
+      break;
+    m_unlink(entry);
+    entry.primitive->setIDforFrame(m_frameId, 0u);
+    m_entries.erase(index);
+    --m_size;
+  }
+}
+
+void PrimitiveTracker::use(
+    const std::shared_ptr<PrimitiveHandleBase> &primitive) {
+  auto &prim = *primitive;
+  if (auto index = prim.getIDforFrame(m_frameId)) {
+    auto &entry = m_entries.at(index);
+    assert(entry.primitive == primitive);
+    entry.epoch = m_epoch;
+    if (m_tail != index) {
+      m_unlink(entry);
+      m_link(index, entry);
+    }
+    return;
+  }
+  auto &&[index, entry] = m_entries.emplace(Entry{primitive, m_epoch});
+  prim.setIDforFrame(m_frameId, index);
+  m_link(index, entry);
+  ++m_size;
+}
+
+void PrimitiveTracker::clear() {
+  for (auto index = m_head; index;) {
+    auto &entry = m_entries.at(index);
+    entry.primitive->setIDforFrame(m_frameId, 0u);
+    index = entry.next;
+  }
+  m_entries.clear();
+  m_head = m_tail = 0u;
+  m_size = 0u;
+}
+
+PrimitiveTracker::~PrimitiveTracker() { clear(); }
+
+void PrimitiveTracker::m_link(unsigned index, Entry &entry) {
+  entry.prev = m_tail;
+  entry.next = 0u;
+  if (m_tail)
+    m_entries.at(m_tail).next = index;
+  else
+    m_head = index;
+  m_tail = index;
+}
+
+void PrimitiveTracker::m_unlink(Entry &entry) {
+  if (entry.prev)
+    m_entries.at(entry.prev).next = entry.next;
+  else
+    m_head = entry.next;
+  if (entry.next)
+    m_entries.at(entry.next).prev = entry.prev;
+  else
+    m_tail = entry.prev;
+}
+
+} // namespace imvk
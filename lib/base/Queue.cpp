@@ -0,0 +1,29 @@
+#include "imvk/base/Queue.hpp"
+
+namespace imvk {
+
+Queue::HandedQueue Queue::acquire() const {
+  return HandedQueue{m_queue, m_batcher.acquire()};
+}
+
+std::future<void> Queue::execute(Job job) const {
+  return m_batcher.execute(
+      [this, job = std::move(job)]() { std::invoke(job, m_queue); });
+}
+
+std::future<void> Queue::submit(SubmitBatch batch, VkFence fence) const {
+  std::vector<SubmitBatch> batches;
+  batches.emplace_back(std::move(batch));
+  return submit(std::move(batches), fence);
+}
+
+std::future<void> Queue::submit(std::vector<SubmitBatch> batches,
+                                VkFence fence) const {
+  return m_batcher.submit(std::move(batches), fence);
+}
+
+void Queue::flush() const { m_batcher.flush(); }
+
+void Queue::flushCoalesced() const { m_batcher.flushCoalesced(); }
+
+} // namespace imvk
@@ -0,0 +1,506 @@
+#include "imvk/base/RenderGraph.hpp"
+#include "imvk/base/Frame.hpp"
+#include "imvk/base/Trace.hpp"
+
+#include "boost/container/small_vector.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace imvk {
+
+namespace {
+
+VkImageAspectFlags aspectOf(VkFormat format) {
+  switch (format) {
+  case VK_FORMAT_D16_UNORM:
+  case VK_FORMAT_X8_D24_UNORM_PACK32:
+  case VK_FORMAT_D32_SFLOAT:
+    return VK_IMAGE_ASPECT_DEPTH_BIT;
+  case VK_FORMAT_S8_UINT:
+    return VK_IMAGE_ASPECT_STENCIL_BIT;
+  case VK_FORMAT_D16_UNORM_S8_UINT:
+  case VK_FORMAT_D24_UNORM_S8_UINT:
+  case VK_FORMAT_D32_SFLOAT_S8_UINT:
+    return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+  default:
+    return VK_IMAGE_ASPECT_COLOR_BIT;
+  }
+}
+
+VkImageUsageFlags usageOf(const ResourceAccess &access) {
+  VkImageUsageFlags ret = 0u;
+  if (access.access & (VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT))
+    ret |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  if (access.access & (VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT))
+    ret |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+  if (access.access & VK_ACCESS_INPUT_ATTACHMENT_READ_BIT)
+    ret |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+  if (access.access & VK_ACCESS_SHADER_WRITE_BIT ||
+      (access.access & VK_ACCESS_SHADER_READ_BIT &&
+       access.layout == VK_IMAGE_LAYOUT_GENERAL))
+    ret |= VK_IMAGE_USAGE_STORAGE_BIT;
+  else if (access.access & VK_ACCESS_SHADER_READ_BIT)
+    ret |= VK_IMAGE_USAGE_SAMPLED_BIT;
+  if (access.access & VK_ACCESS_TRANSFER_READ_BIT)
+    ret |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  if (access.access & VK_ACCESS_TRANSFER_WRITE_BIT)
+    ret |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  return ret;
+}
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1u) / alignment * alignment;
+}
+
+} // namespace
+
+RenderGraphPass &RenderGraphPass::read(RenderGraphImage image,
+                                       const ResourceAccess &access) {
+  m_declare(image.index, access, true, false);
+  return *this;
+}
+
+RenderGraphPass &RenderGraphPass::write(RenderGraphImage image,
+                                        const ResourceAccess &access) {
+  m_declare(image.index, access, false, true);
+  return *this;
+}
+
+RenderGraphPass &RenderGraphPass::read(RenderGraphBuffer buffer,
+                                       const ResourceAccess &access) {
+  m_declare(buffer.index, access, true, false);
+  return *this;
+}
+
+RenderGraphPass &RenderGraphPass::write(RenderGraphBuffer buffer,
+                                        const ResourceAccess &access) {
+  m_declare(buffer.index, access, false, true);
+  return *this;
+}
+
+void RenderGraphPass::m_declare(unsigned resource,
+                                const ResourceAccess &access, bool read,
+                                bool write) {
+  // Several accesses of the same resource are merged, so that each pass
+  // transitions resource at most once.
+  auto found = std::ranges::find(m_accesses, resource, &Access::resource);
+  if (found == m_accesses.end()) {
+    m_accesses.push_back(Access{resource, access, read, write});
+    return;
+  }
+  if (found->access.layout != access.layout)
+    throw std::runtime_error("Pass " + m_name +
+                             " accesses resource in two different layouts.");
+  found->access.stages |= access.stages;
+  found->access.access |= access.access;
+  found->read |= read;
+  found->write |= write;
+}
+
+RenderGraph::RenderGraph(DeviceAllocator &allocator)
+    : m_allocator(allocator) {}
+
+RenderGraphImage RenderGraph::createImage(std::string name,
+                                          const RenderGraphImageInfo &info) {
+  assert(!m_compiled);
+  auto &resource = m_resources.emplace_back();
+  resource.name = std::move(name);
+  resource.isImage = true;
+  resource.imported = false;
+  resource.info = info;
+  resource.aspect = aspectOf(info.format);
+  return {static_cast<unsigned>(m_resources.size() - 1u)};
+}
+
+RenderGraphImage RenderGraph::importImage(std::string name,
+                                          const ResourceAccess &initial,
+                                          const ResourceAccess &final,
+                                          VkImageAspectFlags aspect) {
+  assert(!m_compiled);
+  auto &resource = m_resources.emplace_back();
+  resource.name = std::move(name);
+  resource.isImage = true;
+  resource.imported = true;
+  resource.aspect = aspect;
+  resource.initial = initial;
+  resource.final = final;
+  return {static_cast<unsigned>(m_resources.size() - 1u)};
+}
+
+RenderGraphBuffer RenderGraph::importBuffer(std::string name,
+                                            const ResourceAccess &initial,
+                                            const ResourceAccess &final) {
+  assert(!m_compiled);
+  auto &resource = m_resources.emplace_back();
+  resource.name = std::move(name);
+  resource.isImage = false;
+  resource.imported = true;
+  resource.initial = initial;
+  resource.final = final;
+  return {static_cast<unsigned>(m_resources.size() - 1u)};
+}
+
+RenderGraphPass &RenderGraph::addPass(std::string name, Record record) {
+  assert(!m_compiled);
+  return m_passes.emplace_back(
+      RenderGraphPass{std::move(name), std::move(record)});
+}
+
+void RenderGraph::compile() {
+  assert(!m_compiled);
+  for (auto &pass : m_passes)
+    for (auto &access : pass.m_accesses)
+      if (access.resource >= m_resources.size())
+        throw std::runtime_error("Pass " + pass.m_name +
+                                 " accesses undeclared resource.");
+
+  auto alive = m_cull();
+  std::vector<const RenderGraphPass *> passes;
+  for (size_t i = 0; i < m_passes.size(); ++i)
+    if (alive[i])
+      passes.push_back(&m_passes[i]);
+
+  m_createTransients(passes);
+  m_computeBarriers(passes);
+
+  m_statistics.passCount = passes.size();
+  m_statistics.culledPassCount = m_passes.size() - passes.size();
+  auto account = [&](const Barrier &barrier) {
+    if (barrier.empty())
+      return;
+    ++m_statistics.barrierCount;
+    m_statistics.imageBarrierCount += barrier.images.size();
+  };
+  for (auto &step : m_steps)
+    account(step.barrier);
+  account(m_finalBarrier);
+  m_compiled = true;
+}
+
+std::vector<bool> RenderGraph::m_cull() const {
+  // Walks passes backwards: pass is alive if it has side effects or writes a
+  // resource whose contents are still needed - either by a later alive pass
+  // or, for imported resources, after execution.
+  std::vector<bool> alive(m_passes.size(), false);
+  std::vector<bool> needed(m_resources.size(), false);
+  for (size_t i = 0; i < m_resources.size(); ++i)
+    needed[i] = m_resources[i].imported;
+
+  for (size_t i = m_passes.size(); i-- > 0;) {
+    auto &pass = m_passes[i];
+    alive[i] = pass.m_sideEffects ||
+               std::ranges::any_of(pass.m_accesses, [&](auto &access) {
+                 return access.write && needed[access.resource];
+               });
+    if (!alive[i])
+      continue;
+    // Contents written without reading them are replaced, so earlier
+    // writers are not needed.
+    for (auto &access : pass.m_accesses)
+      if (access.write && !access.read)
+        needed[access.resource] = false;
+    for (auto &access : pass.m_accesses)
+      if (access.read)
+        needed[access.resource] = true;
+  }
+  return alive;
+}
+
+void RenderGraph::m_createTransients(
+    const std::vector<const RenderGraphPass *> &passes) {
+  struct Transient {
+    unsigned resource;
+    unsigned first = ~0u;
+    unsigned last = 0u;
+    VkImageUsageFlags usage = 0u;
+    VkPipelineStageFlags stages = 0u;
+    VkAccessFlags writeAccess = 0u;
+    VkMemoryRequirements requirements{};
+    VkDeviceSize offset = 0u;
+    size_t heap = 0u;
+  };
+
+  std::vector<Transient> transients;
+  std::vector<unsigned> transientOf(m_resources.size(), ~0u);
+  for (unsigned passIndex = 0; passIndex < passes.size(); ++passIndex)
+    for (auto &access : passes[passIndex]->m_accesses) {
+      auto &resource = m_resources[access.resource];
+      if (!resource.isImage || resource.imported)
+        continue;
+      auto &index = transientOf[access.resource];
+      if (index == ~0u) {
+        index = transients.size();
+        transients.push_back(Transient{access.resource});
+      }
+      auto &transient = transients[index];
+      transient.first = std::min(transient.first, passIndex);
+      transient.last = std::max(transient.last, passIndex);
+      transient.usage |= usageOf(access.access);
+      transient.stages |= access.access.stages;
+      transient.writeAccess |= access.access.access & writeAccessMask;
+    }
+
+  auto &device = m_allocator.device();
+  auto &core = device.core<1, 0>();
+  for (auto &transient : transients) {
+    auto &resource = m_resources[transient.resource];
+    VkImageCreateInfo CI{};
+    CI.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    CI.imageType = VK_IMAGE_TYPE_2D;
+    CI.format = resource.info.format;
+    CI.extent = {resource.info.extent.width, resource.info.extent.height, 1u};
+    CI.mipLevels = resource.info.mipLevels;
+    CI.arrayLayers = resource.info.arrayLayers;
+    CI.samples = resource.info.samples;
+    CI.tiling = VK_IMAGE_TILING_OPTIMAL;
+    CI.usage = transient.usage | resource.info.usage;
+    CI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    CI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (core.vkCreateImage(device, &CI, nullptr, &resource.image) !=
+        VK_SUCCESS)
+      throw std::runtime_error("Failed to create transient image " +
+                               resource.name + ".");
+    core.vkGetImageMemoryRequirements(device, resource.image,
+                                      &transient.requirements);
+    m_statistics.unaliasedBytes += transient.requirements.size;
+  }
+
+  // Largest images are placed first, each at the lowest offset where it does
+  // not overlap any placed image that is alive at the same time. Images
+  // that can not share memory type go to separate heaps.
+  struct Heap {
+    uint32_t memoryTypeBits;
+    VkDeviceSize alignment = 1u;
+    VkDeviceSize size = 0u;
+    std::vector<const Transient *> members;
+  };
+  std::vector<Heap> heaps;
+  std::vector<Transient *> bySize;
+  for (auto &transient : transients)
+    bySize.push_back(&transient);
+  std::ranges::stable_sort(bySize, std::ranges::greater{},
+                           [](auto *t) { return t->requirements.size; });
+
+  for (auto *transient : bySize) {
+    auto &requirements = transient->requirements;
+    auto heap = std::ranges::find(heaps, requirements.memoryTypeBits,
+                                  &Heap::memoryTypeBits);
+    if (heap == heaps.end())
+      heap = heaps.insert(heaps.end(), Heap{requirements.memoryTypeBits});
+    VkDeviceSize offset = 0u;
+    for (bool moved = true; moved;) {
+      moved = false;
+      offset = alignUp(offset, requirements.alignment);
+      for (auto *other : heap->members) {
+        bool alive = other->first <= transient->last &&
+                     transient->first <= other->last;
+        bool overlaps =
+            other->offset < offset + requirements.size &&
+            offset < other->offset + other->requirements.size;
+        if (alive && overlaps) {
+          offset = other->offset + other->requirements.size;
+          moved = true;
+          break;
+        }
+      }
+    }
+    transient->offset = offset;
+    transient->heap = heap - heaps.begin();
+    heap->alignment = std::max(heap->alignment, requirements.alignment);
+    heap->size = std::max(heap->size, offset + requirements.size);
+    heap->members.push_back(transient);
+  }
+
+  for (auto &heap : heaps) {
+    auto &memory = m_memory.emplace_back(m_allocator.allocate(
+        VkMemoryRequirements{heap.size, heap.alignment, heap.memoryTypeBits},
+        MemoryUsage::device, /* linear */ false));
+    m_statistics.transientBytes += heap.size;
+    for (auto *transient : heap.members)
+      if (core.vkBindImageMemory(device,
+                                 m_resources[transient->resource].image,
+                                 memory.memory(),
+                                 memory.offset() + transient->offset) !=
+          VK_SUCCESS)
+        throw std::runtime_error("Failed to bind transient image memory.");
+  }
+
+  for (auto &transient : transients) {
+    auto &resource = m_resources[transient.resource];
+    VkImageViewCreateInfo viewCI{};
+    viewCI.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewCI.image = resource.image;
+    viewCI.viewType = resource.info.arrayLayers > 1u
+                          ? VK_IMAGE_VIEW_TYPE_2D_ARRAY
+                          : VK_IMAGE_VIEW_TYPE_2D;
+    viewCI.format = resource.info.format;
+    viewCI.subresourceRange = {resource.aspect, 0u, VK_REMAINING_MIP_LEVELS,
+                               0u, VK_REMAINING_ARRAY_LAYERS};
+    if (core.vkCreateImageView(device, &viewCI, nullptr, &resource.view) !=
+        VK_SUCCESS)
+      throw std::runtime_error("Failed to create transient image view " +
+                               resource.name + ".");
+
+    // Memory of transient image was last accessed, in previous execution,
+    // by itself and images aliasing it. All of them are waited for by it's
+    // first access.
+    auto &heap = heaps[transient.heap];
+    resource.initial = {};
+    for (auto *other : heap.members)
+      if (other->offset < transient.offset + transient.requirements.size &&
+          transient.offset < other->offset + other->requirements.size) {
+        resource.initial.stages |= other->stages;
+        resource.initial.access |= other->writeAccess;
+      }
+  }
+  m_statistics.transientImageCount = transients.size();
+}
+
+void RenderGraph::m_computeBarriers(
+    const std::vector<const RenderGraphPass *> &passes) {
+  std::vector<ResourceState> states(m_resources.size());
+  for (size_t i = 0; i < m_resources.size(); ++i) {
+    auto &resource = m_resources[i];
+    // Transient images start as written by their previous execution, so that
+    // memory they share is not accessed concurrently.
+    states[i] = ResourceState::after(
+        resource.initial, resource.initial.writes() || !resource.imported);
+  }
+
+  auto apply = [&](unsigned index, const ResourceAccess &access, bool write,
+                   Barrier &barrier) {
+    auto dependency =
+        states[index].advance(access, write, m_resources[index].isImage);
+    barrier.srcStages |= dependency.srcStages;
+    barrier.dstStages |= dependency.dstStages;
+    if (dependency.transition)
+      barrier.images.push_back(ImageTransition{
+          index, dependency.oldLayout, access.layout, dependency.srcAccess,
+          dependency.dstAccess});
+    else {
+      barrier.srcAccess |= dependency.srcAccess;
+      barrier.dstAccess |= dependency.dstAccess;
+    }
+  };
+
+  m_steps.clear();
+  for (auto *pass : passes) {
+    auto &step = m_steps.emplace_back(Step{pass});
+    for (auto &access : pass->m_accesses)
+      apply(access.resource, access.access, access.write, step.barrier);
+  }
+
+  m_finalBarrier = {};
+  for (unsigned i = 0; i < m_resources.size(); ++i) {
+    auto &resource = m_resources[i];
+    if (!resource.imported)
+      continue;
+    auto &final = resource.final;
+    // Final access with undefined layout keeps image in whatever layout it
+    // was left in.
+    auto access = final;
+    if (resource.isImage && final.layout == VK_IMAGE_LAYOUT_UNDEFINED)
+      access.layout = states[i].layout;
+    apply(i, access, final.writes(), m_finalBarrier);
+  }
+}
+
+void RenderGraph::bindImage(RenderGraphImage image, VkImage handle,
+                            VkImageView view) {
+  auto &resource = m_resources.at(image.index);
+  assert(resource.isImage && resource.imported);
+  resource.image = handle;
+  resource.view = view;
+}
+
+void RenderGraph::bindBuffer(RenderGraphBuffer buffer, VkBuffer handle) {
+  auto &resource = m_resources.at(buffer.index);
+  assert(!resource.isImage && resource.imported);
+  resource.buffer = handle;
+}
+
+void RenderGraph::execute(const Frame &frame) const {
+  IMVK_TRACE_SCOPE("RenderGraph::execute");
+  assert(m_compiled);
+  VkCommandBuffer commands = frame.commands();
+  for (auto &step : m_steps) {
+    m_recordBarrier(commands, step.barrier);
+    step.pass->m_record(frame, *this);
+  }
+  m_recordBarrier(commands, m_finalBarrier);
+}
+
+void RenderGraph::m_recordBarrier(VkCommandBuffer commands,
+                                  const Barrier &barrier) const {
+  if (barrier.empty())
+    return;
+  boost::container::small_vector<VkImageMemoryBarrier, 8> images;
+  for (auto &transition : barrier.images) {
+    auto &resource = m_resources[transition.resource];
+    assert(resource.image && "imported image is not bound");
+    auto &imageBarrier = images.emplace_back();
+    imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    imageBarrier.srcAccessMask = transition.srcAccess;
+    imageBarrier.dstAccessMask = transition.dstAccess;
+    imageBarrier.oldLayout = transition.oldLayout;
+    imageBarrier.newLayout = transition.newLayout;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = resource.image;
+    imageBarrier.subresourceRange = {resource.aspect, 0u,
+                                     VK_REMAINING_MIP_LEVELS, 0u,
+                                     VK_REMAINING_ARRAY_LAYERS};
+  }
+  // Hazards that need no layout transition are covered by single global
+  // barrier, which is cheaper than per-resource ones.
+  VkMemoryBarrier memory{};
+  memory.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  memory.srcAccessMask = barrier.srcAccess;
+  memory.dstAccessMask = barrier.dstAccess;
+
+  auto &device = m_allocator.device();
+  device.core<1, 0>().vkCmdPipelineBarrier(
+      commands,
+      barrier.srcStages ? barrier.srcStages
+                        : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+      barrier.dstStages ? barrier.dstStages
+                        : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+      0u, barrier.srcAccess || barrier.dstAccess ? 1u : 0u, &memory, 0u,
+      nullptr, images.size(), images.data());
+}
+
+VkImage RenderGraph::image(RenderGraphImage image) const {
+  return m_resources.at(image.index).image;
+}
+
+VkImageView RenderGraph::view(RenderGraphImage image) const {
+  return m_resources.at(image.index).view;
+}
+
+VkBuffer RenderGraph::buffer(RenderGraphBuffer buffer) const {
+  return m_resources.at(buffer.index).buffer;
+}
+
+bool RenderGraph::passAlive(std::string_view name) const {
+  return std::ranges::any_of(
+      m_steps, [&](auto &step) { return step.pass->m_name == name; });
+}
+
+RenderGraph::~RenderGraph() {
+  auto &device = m_allocator.device();
+  auto &core = device.core<1, 0>();
+  for (auto &resource : m_resources) {
+    if (resource.imported)
+      continue;
+    if (resource.view)
+      core.vkDestroyImageView(device, resource.view, nullptr);
+    if (resource.image)
+      core.vkDestroyImage(device, resource.image, nullptr);
+  }
+}
+
+} // namespace imvk
@@ -0,0 +1,49 @@
+#include "imvk/base/Resource.hpp"
+
+#include <stdexcept>
+
+namespace imvk {
+
+Buffer::Buffer(DeviceAllocator &allocator, const VkBufferCreateInfo &CI,
+               MemoryUsage usage)
+    : m_allocator(allocator), m_size(CI.size) {
+  auto &device = m_allocator.device();
+  auto &core = device.core<1, 0>();
+  if (core.vkCreateBuffer(device, &CI, nullptr, &m_buffer) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create buffer.");
+  try {
+    m_allocation = m_allocator.allocate(m_buffer, usage);
+  } catch (...) {
+    core.vkDestroyBuffer(device, m_buffer, nullptr);
+    throw;
+  }
+}
+
+Buffer::~Buffer() {
+  auto &device = m_allocator.device();
+  device.core<1, 0>().vkDestroyBuffer(device, m_buffer, nullptr);
+}
+
+Image::Image(DeviceAllocator &allocator, const VkImageCreateInfo &CI,
+             MemoryUsage usage)
+    : m_allocator(allocator), m_format(CI.format), m_extent(CI.extent),
+      m_mipLevels(CI.mipLevels), m_arrayLayers(CI.arrayLayers) {
+  auto &device = m_allocator.device();
+  auto &core = device.core<1, 0>();
+  if (core.vkCreateImage(device, &CI, nullptr, &m_image) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create image.");
+  try {
+    m_allocation = m_allocator.allocate(
+        m_image, CI.tiling == VK_IMAGE_TILING_LINEAR, usage);
+  } catch (...) {
+    core.vkDestroyImage(device, m_image, nullptr);
+    throw;
+  }
+}
+
+Image::~Image() {
+  auto &device = m_allocator.device();
+  device.core<1, 0>().vkDestroyImage(device, m_image, nullptr);
+}
+
+} // namespace imvk
@@ -0,0 +1,82 @@
+#include "imvk/base/ResourceAccess.hpp"
+
+#include <bit>
+
+namespace imvk {
+
+namespace {
+
+bool visibleTo(const ResourceState &state, const ResourceAccess &access) {
+  for (auto stages = access.stages; stages; stages &= stages - 1u)
+    if ((state.visible[std::countr_zero(stages)] & access.access) !=
+        access.access)
+      return false;
+  return true;
+}
+
+void makeVisible(ResourceState &state, const ResourceAccess &access) {
+  for (auto stages = access.stages; stages; stages &= stages - 1u)
+    state.visible[std::countr_zero(stages)] |= access.access;
+}
+
+// Write is made visible only to it's own accesses.
+void written(ResourceState &state, const ResourceAccess &access) {
+  state.writeStages = access.stages;
+  state.writeAccess = access.access & writeAccessMask;
+  state.readStages = 0u;
+  state.visible.fill(0u);
+  makeVisible(state, access);
+}
+
+} // namespace
+
+ResourceState ResourceState::after(const ResourceAccess &access, bool write) {
+  ResourceState ret;
+  ret.layout = access.layout;
+  if (write)
+    written(ret, access);
+  else
+    ret.readStages = access.stages;
+  return ret;
+}
+
+ResourceDependency ResourceState::advance(const ResourceAccess &access,
+                                          bool write, bool image) {
+  ResourceDependency ret;
+  if (image && access.layout != layout) {
+    // Transition waits for every earlier access and is itself a write.
+    ret.srcStages = writeStages | readStages;
+    ret.dstStages = access.stages;
+    ret.srcAccess = writeAccess;
+    ret.dstAccess = access.access;
+    ret.transition = true;
+    ret.oldLayout = layout;
+    layout = access.layout;
+    written(*this, access);
+  } else if (write) {
+    // Write after write or after read. Latter needs execution dependency
+    // only.
+    if (writeStages | readStages) {
+      ret.srcStages = writeStages | readStages;
+      ret.dstStages = access.stages;
+    }
+    if (writeAccess) {
+      ret.srcAccess = writeAccess;
+      ret.dstAccess = access.access;
+    }
+    written(*this, access);
+  } else {
+    // Read after write. Reads need no ordering among themselves.
+    if (writeStages && !visibleTo(*this, access)) {
+      ret.srcStages = writeStages;
+      ret.srcAccess = writeAccess;
+      ret.dstStages = access.stages;
+      ret.dstAccess = access.access;
+      makeVisible(*this, access);
+    }
+    readStages |= access.stages;
+  }
+  return ret;
+}
+
+} // namespace imvk
@@ -0,0 +1,58 @@
+#include "imvk/base/ResourceAllocators.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace imvk {
+
+BufferSwapAllocator::BufferSwapAllocator(const VkBufferCreateInfo &CI,
+                                         MemoryUsage usage)
+    : m_CI(CI), m_usage(usage) {
+  assert(m_usage != MemoryUsage::device);
+  m_CI.pNext = nullptr;
+}
+
+std::shared_ptr<PrimitiveHandleImpl<Buffer>>
+BufferSwapAllocator::allocate(FramedEngine &engine) const {
+  return std::make_shared<PrimitiveHandleImpl<Buffer>>(
+      engine, engine.context().deviceAllocator(), m_CI, m_usage);
+}
+
+void BufferSwapAllocator::write(Buffer &buffer, const Frame &frame,
+                                VkDeviceSize offset,
+                                std::span<const std::byte> data) const {
+  auto mapped = buffer.mapped();
+  if (offset + data.size() > mapped.size())
+    throw std::runtime_error("Failed to write buffer - out of bounds.");
+  std::memcpy(mapped.data() + offset, data.data(), data.size());
+  buffer.allocation().flush(offset, data.size());
+}
+
+std::shared_ptr<PrimitiveHandleImpl<Image>>
+ImageSwapAllocator::allocate(FramedEngine &engine) const {
+  return std::make_shared<PrimitiveHandleImpl<Image>>(
+      engine, engine.context().deviceAllocator(), m_CI);
+}
+
+std::pair<std::shared_ptr<PrimitiveHandleImpl<Buffer>>,
+          std::shared_future<void>>
+BufferCOWAllocator::allocate(FramedEngine &engine,
+                             std::span<const std::byte> data) const {
+  assert(m_memoryUsage != MemoryUsage::device);
+  VkBufferCreateInfo CI{};
+  CI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  CI.size = data.size();
+  CI.usage = m_usage;
+  CI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  auto buffer = std::make_shared<PrimitiveHandleImpl<Buffer>>(
+      engine, engine.context().deviceAllocator(), CI, m_memoryUsage);
+  std::memcpy(buffer->mapped().data(), data.data(), data.size());
+  buffer->allocation().flush(0u, data.size());
+
+  std::promise<void> ready;
+  ready.set_value();
+  return {std::move(buffer), ready.get_future().share()};
+}
+
+} // namespace imvk
@@ -0,0 +1,209 @@
+#include "imvk/base/ResourceStateTracker.hpp"
+#include "imvk/base/Trace.hpp"
+
+#include <stdexcept>
+
+namespace imvk {
+
+void ResourceStateTracker::track(VkImage image, const ResourceAccess &initial,
+                                 unsigned mipLevels, unsigned arrayLayers,
+                                 VkImageAspectFlags aspect) {
+  auto &tracked = m_images[image];
+  tracked.aspect = aspect;
+  tracked.mipLevels = mipLevels;
+  tracked.arrayLayers = arrayLayers;
+  tracked.subresources.assign(
+      mipLevels * arrayLayers,
+      Entry{ResourceState::after(initial, initial.writes())});
+}
+
+void ResourceStateTracker::track(VkBuffer buffer,
+                                 const ResourceAccess &initial) {
+  m_buffers[buffer] = Entry{ResourceState::after(initial, initial.writes())};
+}
+
+ResourceDependency ResourceStateTracker::m_advance(
+    Entry &entry, const ResourceAccess &access, bool image) {
+  auto write = access.writes();
+  auto dependency = entry.state.advance(access, write, image);
+  // Pending barrier is recorded before accesses required since last flush,
+  // so it can not wait for them. Reads wait for last write only, writes and
+  // transitions wait for reads since it as well.
+  auto waitsForAll = write || dependency.transition;
+  auto pending = waitsForAll ? entry.batch == m_batch
+                             : entry.writeBatch == m_batch;
+  if (!dependency.empty() && pending)
+    flush();
+  entry.batch = m_batch;
+  if (waitsForAll)
+    entry.writeBatch = m_batch;
+  return dependency;
+}
+
+void ResourceStateTracker::require(VkImage image,
+                                   const VkImageSubresourceRange &range,
+                                   const ResourceAccess &access) {
+  auto found = m_images.find(image);
+  if (found == m_images.end())
+    throw std::runtime_error("Required image is not tracked.");
+  auto &tracked = found->second;
+  auto levelCount = range.levelCount == VK_REMAINING_MIP_LEVELS
+                        ? tracked.mipLevels - range.baseMipLevel
+                        : range.levelCount;
+  auto layerCount = range.layerCount == VK_REMAINING_ARRAY_LAYERS
+                        ? tracked.arrayLayers - range.baseArrayLayer
+                        : range.layerCount;
+  if (range.baseMipLevel + levelCount > tracked.mipLevels ||
+      range.baseArrayLayer + layerCount > tracked.arrayLayers)
+    throw std::runtime_error("Required range exceeds tracked image.");
+
+  for (auto level = range.baseMipLevel;
+       level < range.baseMipLevel + levelCount; ++level)
+    for (auto layer = range.baseArrayLayer;
+         layer < range.baseArrayLayer + layerCount; ++layer) {
+      auto &entry = tracked.subresources[level * tracked.arrayLayers + layer];
+      auto dependency = m_advance(entry, access, /* image */ true);
+      m_srcStages |= dependency.srcStages;
+      m_dstStages |= dependency.dstStages;
+      if (dependency.transition)
+        m_addImageBarrier(image, tracked, dependency, access.layout, level,
+                          layer);
+      else {
+        m_srcAccess |= dependency.srcAccess;
+        m_dstAccess |= dependency.dstAccess;
+      }
+    }
+}
+
+void ResourceStateTracker::require(VkImage image,
+                                   const ResourceAccess &access) {
+  require(image,
+          VkImageSubresourceRange{0u, 0u, VK_REMAINING_MIP_LEVELS, 0u,
+                                  VK_REMAINING_ARRAY_LAYERS},
+          access);
+}
+
+void ResourceStateTracker::require(VkBuffer buffer,
+                                   const ResourceAccess &access) {
+  auto found = m_buffers.find(buffer);
+  if (found == m_buffers.end())
+    throw std::runtime_error("Required buffer is not tracked.");
+  auto dependency = m_advance(found->second, access, /* image */ false);
+  m_srcStages |= dependency.srcStages;
+  m_dstStages |= dependency.dstStages;
+  m_srcAccess |= dependency.srcAccess;
+  m_dstAccess |= dependency.dstAccess;
+}
+
+void ResourceStateTracker::m_addImageBarrier(
+    VkImage image, const Image &tracked, const ResourceDependency &dependency,
+    VkImageLayout newLayout, unsigned mipLevel, unsigned arrayLayer) {
+  auto sameTransition = [&](const VkImageMemoryBarrier &barrier) {
+    return barrier.image == image &&
+           barrier.oldLayout == dependency.oldLayout &&
+           barrier.newLayout == newLayout &&
+           barrier.srcAccessMask == dependency.srcAccess &&
+           barrier.dstAccessMask == dependency.dstAccess;
+  };
+
+  // Subresources are required in order of mip levels and array layers, so
+  // consecutive layers of a level are merged into previous barrier, and
+  // levels covering the same layers are merged into the one before.
+  if (!m_imageBarriers.empty()) {
+    auto &last = m_imageBarriers.back();
+    auto &range = last.subresourceRange;
+    if (sameTransition(last) && range.levelCount == 1u &&
+        range.baseMipLevel == mipLevel &&
+        range.baseArrayLayer + range.layerCount == arrayLayer) {
+      ++range.layerCount;
+      if (m_imageBarriers.size() > 1u) {
+        auto &previous = *(m_imageBarriers.end() - 2);
+        auto &previousRange = previous.subresourceRange;
+        if (sameTransition(previous) &&
+            previousRange.baseMipLevel + previousRange.levelCount ==
+                mipLevel &&
+            previousRange.baseArrayLayer == range.baseArrayLayer &&
+            previousRange.layerCount == range.layerCount) {
+          ++previousRange.levelCount;
+          m_imageBarriers.pop_back();
+        }
+      }
+      return;
+    }
+  }
+
+  auto &barrier = m_imageBarriers.emplace_back();
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcAccessMask = dependency.srcAccess;
+  barrier.dstAccessMask = dependency.dstAccess;
+  barrier.oldLayout = dependency.oldLayout;
+  barrier.newLayout = newLayout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange = {tracked.aspect, mipLevel, 1u, arrayLayer, 1u};
+
+  // Ranges of single layer never extend a barrier above, so their levels are
+  // merged right away.
+  if (m_imageBarriers.size() > 1u) {
+    auto &previous = *(m_imageBarriers.end() - 2);
+    auto &previousRange = previous.subresourceRange;
+    if (sameTransition(previous) &&
+        previousRange.baseMipLevel + previousRange.levelCount == mipLevel &&
+        previousRange.baseArrayLayer == arrayLayer &&
+        previousRange.layerCount == 1u) {
+      ++previousRange.levelCount;
+      m_imageBarriers.pop_back();
+    }
+  }
+}
+
+VkImageLayout ResourceStateTracker::layout(VkImage image, unsigned mipLevel,
+                                           unsigned arrayLayer) const {
+  auto &tracked = m_images.at(image);
+  return tracked.subresources
+      .at(mipLevel * tracked.arrayLayers + arrayLayer)
+      .state.layout;
+}
+
+void ResourceStateTracker::flush() {
+  if (!m_srcStages && !m_dstStages && m_imageBarriers.empty())
+    return;
+  IMVK_TRACE_SCOPE("ResourceStateTracker::flush");
+
+  // Hazards that need no layout transition are covered by single global
+  // barrier, which is cheaper than per-resource ones.
+  VkMemoryBarrier memory{};
+  memory.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  memory.srcAccessMask = m_srcAccess;
+  memory.dstAccessMask = m_dstAccess;
+
+  m_device.core<1, 0>().vkCmdPipelineBarrier(
+      m_commands,
+      m_srcStages ? m_srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+      m_dstStages ? m_dstStages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0u,
+      m_srcAccess || m_dstAccess ? 1u : 0u, &memory, 0u, nullptr,
+      m_imageBarriers.size(), m_imageBarriers.data());
+
+  ++m_barrierCount;
+  ++m_batch;
+  m_srcStages = 0u;
+  m_dstStages = 0u;
+  m_srcAccess = 0u;
+  m_dstAccess = 0u;
+  m_imageBarriers.clear();
+}
+
+void ResourceStateTracker::reset() {
+  m_images.clear();
+  m_buffers.clear();
+  ++m_batch;
+  m_srcStages = 0u;
+  m_dstStages = 0u;
+  m_srcAccess = 0u;
+  m_dstAccess = 0u;
+  m_imageBarriers.clear();
+  m_barrierCount = 0u;
+}
+
+} // namespace imvk
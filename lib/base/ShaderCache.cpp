@@ -0,0 +1,55 @@
+#include "imvk/base/ShaderCache.hpp"
+
+#include <chrono>
+
+namespace imvk {
+
+std::shared_ptr<vkw::SPIRVModule>
+CachingShaderFactory::getModule(std::string_view name) {
+  auto hash = NameHash{}(name);
+  // Low bits select bucket inside of shard, so take shard from high ones.
+  auto &shard = m_shards[(hash >> 32u) % m_shardCount];
+
+  auto lock = std::unique_lock{shard.mutex};
+  if (auto found = shard.modules.find(name); found != shard.modules.end()) {
+    auto future = found->second.future;
+    lock.unlock();
+    if (future.wait_for(std::chrono::seconds{0}) == std::future_status::ready)
+      m_hits.fetch_add(1u, std::memory_order_relaxed);
+    else
+      m_coalesced.fetch_add(1u, std::memory_order_relaxed);
+    return future.get();
+  }
+
+  std::promise<std::shared_ptr<vkw::SPIRVModule>> promise;
+  auto ticket = shard.nextTicket++;
+  shard.modules.emplace(std::string{name},
+                        Entry{promise.get_future().share(), ticket});
+  lock.unlock();
+  m_misses.fetch_add(1u, std::memory_order_relaxed);
+
+  try {
+    auto module = m_factory.getModule(name);
+    promise.set_value(module);
+    return module;
+  } catch (...) {
+    lock.lock();
+    // clear() may have dropped this entry and another thread may have
+    // inserted a fresh one since - leave it alone.
+    if (auto found = shard.modules.find(name);
+        found != shard.modules.end() && found->second.ticket == ticket)
+      shard.modules.erase(found);
+    lock.unlock();
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+}
+
+void CachingShaderFactory::clear() {
+  for (auto &shard : m_shards) {
+    auto lock = std::unique_lock{shard.mutex};
+    shard.modules.clear();
+  }
+}
+
+} // namespace imvk
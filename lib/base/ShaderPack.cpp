@@ -0,0 +1,171 @@
+#include "imvk/base/ShaderPack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace imvk {
+
+namespace {
+
+[[noreturn]] void throwPackError(const std::filesystem::path &path,
+                                 std::string_view what) {
+  std::stringstream ss;
+  ss << "Could not load shader pack " << path << ":\n";
+  ss << what << "\n";
+  throw std::runtime_error(ss.str());
+}
+
+} // namespace
+
+ShaderPack::ShaderPack(const std::filesystem::path &path) {
+  m_map(path);
+  try {
+    m_validate(path);
+  } catch (...) {
+    m_unmap();
+    throw;
+  }
+}
+
+std::optional<std::span<const uint32_t>>
+ShaderPack::find(std::string_view name) const {
+  auto hash = shader_pack::hashName(name);
+  auto [first, last] = std::ranges::equal_range(m_index, hash, {},
+                                                &shader_pack::Entry::nameHash);
+  for (auto &entry : std::ranges::subrange(first, last)) {
+    if (m_strings.substr(entry.nameOffset, entry.nameSize) != name)
+      continue;
+    return std::span{
+        reinterpret_cast<const uint32_t *>(m_data + entry.codeOffset),
+        entry.codeSize / 4u};
+  }
+  return std::nullopt;
+}
+
+std::shared_ptr<vkw::SPIRVModule>
+ShaderPack::getModule(std::string_view name) {
+  auto code = find(name);
+  if (!code)
+    throw std::runtime_error([&]() {
+      std::stringstream ss;
+      ss << "Could not load shader '" << name << "':\n";
+      ss << "no such shader in pack\n";
+      return ss.str();
+    }());
+  return std::make_shared<vkw::SPIRVModule>(*code);
+}
+
+ShaderPack::~ShaderPack() { m_unmap(); }
+
+#ifdef _WIN32
+
+void ShaderPack::m_map(const std::filesystem::path &path) {
+  m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (m_file == INVALID_HANDLE_VALUE) {
+    m_file = nullptr;
+    throwPackError(path, "failed to open file for reading");
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+    CloseHandle(m_file);
+    throwPackError(path, "failed to query file size or file is empty");
+  }
+  m_size = static_cast<size_t>(size.QuadPart);
+  m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_mapping) {
+    CloseHandle(m_file);
+    throwPackError(path, "failed to create file mapping");
+  }
+  m_data = static_cast<const std::byte *>(
+      MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!m_data) {
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    throwPackError(path, "failed to map file");
+  }
+}
+
+void ShaderPack::m_unmap() {
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping);
+  CloseHandle(m_file);
+}
+
+#else
+
+void ShaderPack::m_map(const std::filesystem::path &path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    throwPackError(path, "failed to open file for reading");
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    throwPackError(path, "failed to query file size or file is empty");
+  }
+  m_size = static_cast<size_t>(st.st_size);
+  auto *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // Mapping holds it's own reference to the file.
+  close(fd);
+  if (data == MAP_FAILED)
+    throwPackError(path, "failed to map file");
+  m_data = static_cast<const std::byte *>(data);
+}
+
+void ShaderPack::m_unmap() {
+  munmap(const_cast<std::byte *>(m_data), m_size);
+}
+
+#endif
+
+void ShaderPack::m_validate(const std::filesystem::path &path) {
+  shader_pack::Header header;
+  if (m_size < sizeof(header))
+    throwPackError(path, "file is too small");
+  std::memcpy(&header, m_data, sizeof(header));
+  if (std::memcmp(header.magic, shader_pack::magic, sizeof(header.magic)))
+    throwPackError(path, "not a shader pack");
+  if (header.version != shader_pack::version)
+    throwPackError(path, "unsupported version");
+
+  auto inBounds = [&](uint64_t offset, uint64_t size) {
+    return offset <= m_size && size <= m_size - offset;
+  };
+  auto indexSize = uint64_t{header.entryCount} * sizeof(shader_pack::Entry);
+  if (header.indexOffset % alignof(shader_pack::Entry) ||
+      !inBounds(header.indexOffset, indexSize) ||
+      !inBounds(header.stringsOffset, header.stringsSize))
+    throwPackError(path, "index is out of file bounds");
+
+  m_index = std::span{reinterpret_cast<const shader_pack::Entry *>(
+                          m_data + header.indexOffset),
+                      header.entryCount};
+  m_strings = std::string_view{
+      reinterpret_cast<const char *>(m_data + header.stringsOffset),
+      header.stringsSize};
+
+  // Checked once here, so lookups may trust the index.
+  if (!std::ranges::is_sorted(m_index, {}, &shader_pack::Entry::nameHash))
+    throwPackError(path, "index is not sorted");
+  for (auto &entry : m_index) {
+    if (uint64_t{entry.nameOffset} + entry.nameSize > m_strings.size() ||
+        entry.codeOffset % 4u || entry.codeSize % 4u ||
+        !inBounds(entry.codeOffset, entry.codeSize))
+      throwPackError(path, "corrupted index entry");
+  }
+}
+
+} // namespace imvk
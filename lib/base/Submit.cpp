@@ -0,0 +1,51 @@
+#include "imvk/base/Submit.hpp"
+
+#include <stdexcept>
+
+namespace imvk {
+
+SubmitBatch &SubmitBatch::operator=(const SubmitBatch &another) {
+  // VkSubmitInfo of another batch points into it's storage - only copy
+  // storage and let info() rebuild pointers.
+  m_commandBuffers = another.m_commandBuffers;
+  m_waitSemaphores = another.m_waitSemaphores;
+  m_waitStages = another.m_waitStages;
+  m_waitValues = another.m_waitValues;
+  m_signalSemaphores = another.m_signalSemaphores;
+  m_signalValues = another.m_signalValues;
+  return *this;
+}
+
+const VkSubmitInfo &SubmitBatch::info() {
+  m_timelineInfo = VkTimelineSemaphoreSubmitInfo{};
+  m_timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  m_timelineInfo.waitSemaphoreValueCount = m_waitValues.size();
+  m_timelineInfo.pWaitSemaphoreValues = m_waitValues.data();
+  m_timelineInfo.signalSemaphoreValueCount = m_signalValues.size();
+  m_timelineInfo.pSignalSemaphoreValues = m_signalValues.data();
+
+  m_info = VkSubmitInfo{};
+  m_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  m_info.pNext = &m_timelineInfo;
+  m_info.waitSemaphoreCount = m_waitSemaphores.size();
+  m_info.pWaitSemaphores = m_waitSemaphores.data();
+  m_info.pWaitDstStageMask = m_waitStages.data();
+  m_info.commandBufferCount = m_commandBuffers.size();
+  m_info.pCommandBuffers = m_commandBuffers.data();
+  m_info.signalSemaphoreCount = m_signalSemaphores.size();
+  m_info.pSignalSemaphores = m_signalSemaphores.data();
+  return m_info;
+}
+
+void submit(vkw::Device &device, vkw::Queue &queue,
+            std::span<SubmitBatch> batches, VkFence fence) {
+  std::vector<VkSubmitInfo> infos;
+  infos.reserve(batches.size());
+  for (auto &batch : batches)
+    infos.push_back(batch.info());
+  if (device.core<1, 0>().vkQueueSubmit(queue, infos.size(), infos.data(),
+                                        fence) != VK_SUCCESS)
+    throw std::runtime_error("Failed to submit to queue.");
+}
+
+} // namespace imvk
@@ -0,0 +1,221 @@
+#include "imvk/base/SubmitBatcher.hpp"
+#include "imvk/base/Trace.hpp"
+
+#include <algorithm>
+
+namespace imvk {
+
+void SubmitBatcher::introduceSubmitThread() {
+  if (m_submitter)
+    return;
+  introduceLock();
+  m_submitter = std::make_unique<Submitter>();
+  m_submitter->thread = std::thread{[this]() { m_submitLoop(); }};
+}
+
+void SubmitBatcher::giveUpSubmitThread() {
+  if (!m_submitter)
+    return;
+  // Stop request is executed after every task pushed before it.
+  m_push(Task{Task::Kind::stop});
+  m_submitter->thread.join();
+  m_submitter.reset();
+}
+
+std::unique_lock<std::mutex> SubmitBatcher::acquire() const {
+  IMVK_TRACE_SCOPE("SubmitBatcher::acquire");
+  if (m_submitter)
+    m_drain();
+  auto ret =
+      m_mutex ? std::unique_lock{*m_mutex} : std::unique_lock<std::mutex>{};
+  m_flushPending();
+  return ret;
+}
+
+std::future<void> SubmitBatcher::execute(Job job) const {
+  Task task{Task::Kind::job, std::move(job)};
+  auto ret = task.promise.get_future();
+
+  if (!m_submitter) {
+    auto lock = acquire();
+    try {
+      std::invoke(task.job);
+      task.promise.set_value();
+    } catch (...) {
+      task.promise.set_exception(std::current_exception());
+    }
+    return ret;
+  }
+
+  m_push(std::move(task));
+  return ret;
+}
+
+std::future<void> SubmitBatcher::submit(std::vector<SubmitBatch> batches,
+                                        VkFence fence) const {
+  Task task{Task::Kind::submit, nullptr, std::move(batches), fence};
+  auto ret = task.promise.get_future();
+
+  if (!m_submitter) {
+    auto lock = m_mutex ? std::unique_lock{*m_mutex}
+                        : std::unique_lock<std::mutex>{};
+    m_enqueueSubmit(std::move(task));
+    return ret;
+  }
+
+  m_push(std::move(task));
+  return ret;
+}
+
+void SubmitBatcher::flush() const {
+  if (m_submitter) {
+    // Any job flushes pending submissions before it is executed.
+    m_push(Task{Task::Kind::job, []() {}});
+    return;
+  }
+  auto lock =
+      m_mutex ? std::unique_lock{*m_mutex} : std::unique_lock<std::mutex>{};
+  m_flushPending();
+}
+
+void SubmitBatcher::flushCoalesced() const {
+  if (m_submitter)
+    return;
+  auto lock =
+      m_mutex ? std::unique_lock{*m_mutex} : std::unique_lock<std::mutex>{};
+  auto pendingLock = std::unique_lock{m_pendingMutex};
+  if (m_pendingBatches.empty())
+    return;
+  auto deadline = m_pendingSince + m_coalescingWindow;
+  auto submitCalls = m_submitCalls.load(std::memory_order_relaxed);
+  pendingLock.unlock();
+  if (lock)
+    lock.unlock();
+  std::this_thread::sleep_until(deadline);
+  if (m_mutex)
+    lock.lock();
+  pendingLock.lock();
+  // Pending group may have been flushed meanwhile by a fenced submission or
+  // another caller - the one pending now is not due yet.
+  if (m_submitCalls.load(std::memory_order_relaxed) == submitCalls)
+    m_issuePending(VK_NULL_HANDLE);
+}
+
+void SubmitBatcher::m_push(Task &&task) const {
+  // Ring is full only if submitter falls far behind - just let it catch up.
+  while (!m_submitter->ring.tryPush(std::move(task)))
+    std::this_thread::yield();
+  m_submitter->pushed.fetch_add(1u);
+  if (m_submitter->sleeping.load()) {
+    auto lock = std::lock_guard{m_submitter->wakeMutex};
+    m_submitter->wakeCv.notify_one();
+  }
+}
+
+void SubmitBatcher::m_drain() const { execute([]() {}).wait(); }
+
+void SubmitBatcher::m_enqueueSubmit(Task &&task) const {
+  auto lock = std::unique_lock{m_pendingMutex};
+  if (m_pendingBatches.empty())
+    m_pendingSince = std::chrono::steady_clock::now();
+  m_batches.fetch_add(task.batches.size(), std::memory_order_relaxed);
+  std::ranges::move(task.batches, std::back_inserter(m_pendingBatches));
+  m_pendingPromises.emplace_back(std::move(task.promise));
+
+  // Fence closes the group - one vkQueueSubmit may only signal one fence.
+  if (task.fence != VK_NULL_HANDLE) {
+    m_issuePending(task.fence);
+    return;
+  }
+  // Submitter thread tracks the window itself. Otherwise it is checked on
+  // every submission and by flushCoalesced() callers waiting for it.
+  if (!m_submitter &&
+      (m_coalescingWindow.count() == 0 ||
+       std::chrono::steady_clock::now() - m_pendingSince >= m_coalescingWindow))
+    m_issuePending(VK_NULL_HANDLE);
+}
+
+void SubmitBatcher::m_flushPending(VkFence fence) const {
+  auto lock = std::unique_lock{m_pendingMutex};
+  m_issuePending(fence);
+}
+
+void SubmitBatcher::m_issuePending(VkFence fence) const {
+  if (m_pendingBatches.empty())
+    return;
+  IMVK_TRACE_SCOPE("SubmitBatcher::flushPending");
+  try {
+    std::invoke(m_sink, std::span{m_pendingBatches}, fence);
+    for (auto &promise : m_pendingPromises)
+      promise.set_value();
+  } catch (...) {
+    for (auto &promise : m_pendingPromises)
+      promise.set_exception(std::current_exception());
+  }
+  m_submitCalls.fetch_add(1u, std::memory_order_relaxed);
+  m_pendingBatches.clear();
+  m_pendingPromises.clear();
+}
+
+void SubmitBatcher::m_submitLoop() {
+  trace::setThreadName("imvk queue submitter");
+  auto &submitter = *m_submitter;
+  uint64_t consumed = 0u;
+  for (;;) {
+    auto pushed = submitter.pushed.load(std::memory_order_acquire);
+    if (consumed >= pushed) {
+      std::optional<std::chrono::steady_clock::time_point> deadline;
+      {
+        auto pendingLock = std::unique_lock{m_pendingMutex};
+        if (!m_pendingBatches.empty())
+          deadline = m_pendingSince + m_coalescingWindow;
+      }
+      if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+        auto lock = std::unique_lock{*m_mutex};
+        m_flushPending();
+        continue;
+      }
+      // Sleep until a new task arrives or, if there are pending submissions,
+      // until their window closes - other engines may join them meanwhile.
+      auto wakeLock = std::unique_lock{submitter.wakeMutex};
+      submitter.sleeping.store(true);
+      auto hasTasks = [&]() { return submitter.pushed.load() > consumed; };
+      if (deadline)
+        submitter.wakeCv.wait_until(wakeLock, *deadline, hasTasks);
+      else
+        submitter.wakeCv.wait(wakeLock, hasTasks);
+      submitter.sleeping.store(false);
+      continue;
+    }
+
+    // Execute everything available holding the lock once, so that acquire()
+    // callers are serialized with this thread.
+    auto lock = std::unique_lock{*m_mutex};
+    while (auto task = submitter.ring.tryPop()) {
+      ++consumed;
+      switch (task->kind) {
+      case Task::Kind::submit:
+        m_enqueueSubmit(std::move(*task));
+        break;
+      case Task::Kind::job:
+        m_flushPending();
+        try {
+          std::invoke(task->job);
+          task->promise.set_value();
+        } catch (...) {
+          task->promise.set_exception(std::current_exception());
+        }
+        break;
+      case Task::Kind::stop:
+        m_flushPending();
+        return;
+      }
+    }
+    // With no window everything submitted while this thread was busy is
+    // merged together.
+    if (m_coalescingWindow.count() == 0)
+      m_flushPending();
+  }
+}
+
+} // namespace imvk
@@ -0,0 +1,179 @@
+#include "imvk/base/TLSF.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace imvk {
+
+TLSFHeap::TLSFHeap(uint64_t size) : m_size(size) {
+  for (auto &lists : m_freeLists)
+    lists.fill(m_null);
+  if (!size)
+    return;
+  auto block = m_newBlock();
+  m_blocks[block].offset = 0u;
+  m_blocks[block].size = size;
+  m_insertFree(block);
+}
+
+std::pair<unsigned, unsigned> TLSFHeap::m_mapping(uint64_t size) {
+  // Sizes below m_slCount are linearly mapped to first level.
+  if (size < m_slCount)
+    return {0u, static_cast<unsigned>(size)};
+  unsigned fl = std::bit_width(size) - 1u;
+  unsigned sl = static_cast<unsigned>(size >> (fl - m_slBits)) ^ m_slCount;
+  return {fl - m_slBits + 1u, sl};
+}
+
+std::optional<TLSFHeap::Allocation> TLSFHeap::allocate(uint64_t size,
+                                                       uint64_t alignment) {
+  assert(std::has_single_bit(alignment));
+  if (!size)
+    size = 1u;
+  // Any block found for this size can hold aligned allocation.
+  auto searchSize = size + alignment - 1u;
+  if (searchSize < size)
+    return std::nullopt;
+  auto block = m_findFree(searchSize);
+  if (block == m_null)
+    return std::nullopt;
+  m_removeFree(block);
+
+  auto offset = m_blocks[block].offset;
+  auto aligned = (offset + alignment - 1u) & ~(alignment - 1u);
+  if (aligned != offset) {
+    auto padding = aligned - offset;
+    auto prev = m_blocks[block].prevPhysical;
+    if (prev != m_null && padding < m_slCount) {
+      // Too small to be worth tracking - let previous block own it.
+      m_blocks[prev].size += padding;
+      m_blocks[block].offset = aligned;
+      m_blocks[block].size -= padding;
+      m_used += padding;
+    } else {
+      auto rest = m_split(block, padding);
+      m_insertFree(block);
+      block = rest;
+    }
+  }
+
+  if (m_blocks[block].size - size >= m_slCount)
+    m_insertFree(m_split(block, size));
+
+  m_blocks[block].free = false;
+  m_used += m_blocks[block].size;
+  return Allocation{m_blocks[block].offset, block};
+}
+
+void TLSFHeap::free(Handle handle) {
+  assert(handle < m_blocks.size() && !m_blocks[handle].free);
+  m_used -= m_blocks[handle].size;
+
+  auto next = m_blocks[handle].nextPhysical;
+  if (next != m_null && m_blocks[next].free) {
+    m_removeFree(next);
+    m_merge(handle, next);
+  }
+  auto prev = m_blocks[handle].prevPhysical;
+  if (prev != m_null && m_blocks[prev].free) {
+    m_removeFree(prev);
+    m_merge(prev, handle);
+    handle = prev;
+  }
+  m_insertFree(handle);
+}
+
+TLSFHeap::Handle TLSFHeap::m_newBlock() {
+  if (!m_unusedBlocks.empty()) {
+    auto ret = m_unusedBlocks.back();
+    m_unusedBlocks.pop_back();
+    m_blocks[ret] = Block{};
+    return ret;
+  }
+  m_blocks.emplace_back();
+  return static_cast<Handle>(m_blocks.size() - 1u);
+}
+
+void TLSFHeap::m_insertFree(Handle block) {
+  auto &b = m_blocks[block];
+  auto [fl, sl] = m_mapping(b.size);
+  auto &head = m_freeLists[fl][sl];
+  b.free = true;
+  b.prevFree = m_null;
+  b.nextFree = head;
+  if (head != m_null)
+    m_blocks[head].prevFree = block;
+  head = block;
+  m_flBitmap |= uint64_t{1u} << fl;
+  m_slBitmaps[fl] |= 1u << sl;
+}
+
+void TLSFHeap::m_removeFree(Handle block) {
+  auto &b = m_blocks[block];
+  auto [fl, sl] = m_mapping(b.size);
+  if (b.prevFree != m_null)
+    m_blocks[b.prevFree].nextFree = b.nextFree;
+  else
+    m_freeLists[fl][sl] = b.nextFree;
+  if (b.nextFree != m_null)
+    m_blocks[b.nextFree].prevFree = b.prevFree;
+  if (m_freeLists[fl][sl] == m_null) {
+    m_slBitmaps[fl] &= ~(1u << sl);
+    if (!m_slBitmaps[fl])
+      m_flBitmap &= ~(uint64_t{1u} << fl);
+  }
+  b.free = false;
+  b.prevFree = b.nextFree = m_null;
+}
+
+TLSFHeap::Handle TLSFHeap::m_findFree(uint64_t size) {
+  // Round size up to next size class, so that any block of found class fits.
+  if (size >= m_slCount) {
+    auto round = (uint64_t{1u} << (std::bit_width(size) - 1u - m_slBits)) - 1u;
+    if (size + round < size)
+      return m_null;
+    size += round;
+  }
+  auto [fl, sl] = m_mapping(size);
+  if (fl >= m_flCount)
+    return m_null;
+
+  auto slMap = m_slBitmaps[fl] & (~0u << sl);
+  if (!slMap) {
+    auto flMap =
+        fl + 1u < 64u ? m_flBitmap & (~uint64_t{0u} << (fl + 1u)) : 0u;
+    if (!flMap)
+      return m_null;
+    fl = std::countr_zero(flMap);
+    slMap = m_slBitmaps[fl];
+  }
+  sl = std::countr_zero(slMap);
+  return m_freeLists[fl][sl];
+}
+
+TLSFHeap::Handle TLSFHeap::m_split(Handle block, uint64_t size) {
+  auto rest = m_newBlock();
+  auto &b = m_blocks[block];
+  auto &r = m_blocks[rest];
+  r.offset = b.offset + size;
+  r.size = b.size - size;
+  r.prevPhysical = block;
+  r.nextPhysical = b.nextPhysical;
+  if (b.nextPhysical != m_null)
+    m_blocks[b.nextPhysical].prevPhysical = rest;
+  b.size = size;
+  b.nextPhysical = rest;
+  return rest;
+}
+
+void TLSFHeap::m_merge(Handle block, Handle next) {
+  auto &b = m_blocks[block];
+  auto &n = m_blocks[next];
+  b.size += n.size;
+  b.nextPhysical = n.nextPhysical;
+  if (n.nextPhysical != m_null)
+    m_blocks[n.nextPhysical].prevPhysical = block;
+  m_unusedBlocks.push_back(next);
+}
+
+} // namespace imvk
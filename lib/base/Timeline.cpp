@@ -0,0 +1,58 @@
+#include "imvk/base/Timeline.hpp"
+
+#include <stdexcept>
+
+namespace imvk {
+
+TimelineSemaphore::TimelineSemaphore(vkw::Device &device,
+                                     uint64_t initialValue)
+    : m_device(device) {
+  VkSemaphoreTypeCreateInfo typeCI{};
+  typeCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  typeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  typeCI.initialValue = initialValue;
+
+  VkSemaphoreCreateInfo CI{};
+  CI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  CI.pNext = &typeCI;
+
+  if (m_device.core<1, 0>().vkCreateSemaphore(m_device, &CI, nullptr,
+                                              &m_semaphore) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create timeline semaphore.");
+}
+
+uint64_t TimelineSemaphore::value() const {
+  uint64_t ret = 0;
+  m_device.core<1, 2>().vkGetSemaphoreCounterValue(m_device, m_semaphore,
+                                                   &ret);
+  return ret;
+}
+
+bool TimelineSemaphore::wait(uint64_t value, uint64_t timeout) const {
+  VkSemaphoreWaitInfo waitInfo{};
+  waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &m_semaphore;
+  waitInfo.pValues = &value;
+  auto result =
+      m_device.core<1, 2>().vkWaitSemaphores(m_device, &waitInfo, timeout);
+  if (result == VK_TIMEOUT)
+    return false;
+  if (result != VK_SUCCESS)
+    throw std::runtime_error("Failed to wait for timeline semaphore.");
+  return true;
+}
+
+void TimelineSemaphore::signal(uint64_t value) {
+  VkSemaphoreSignalInfo signalInfo{};
+  signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+  signalInfo.semaphore = m_semaphore;
+  signalInfo.value = value;
+  m_device.core<1, 2>().vkSignalSemaphore(m_device, &signalInfo);
+}
+
+TimelineSemaphore::~TimelineSemaphore() {
+  m_device.core<1, 0>().vkDestroySemaphore(m_device, m_semaphore, nullptr);
+}
+
+} // namespace imvk
@@ -0,0 +1,232 @@
+#include "imvk/base/Trace.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace imvk::trace {
+
+namespace {
+
+// Spans each thread may record between two drains.
+constexpr uint64_t ringCapacity = 1u << 16u;
+
+struct Event {
+  const char *name;
+  uint64_t begin;
+  uint64_t end;
+};
+
+// Written by owning thread only, read by thread holding registry lock.
+struct ThreadBuffer {
+  unsigned tid = 0u;
+  std::atomic<const char *> name = nullptr;
+  std::unique_ptr<Event[]> events = std::make_unique<Event[]>(ringCapacity);
+  std::atomic<uint64_t> head = 0u;
+  std::atomic<uint64_t> tail = 0u;
+  // Set once owning thread exits - buffer is dropped once drained.
+  std::atomic<bool> retired = false;
+};
+
+class Writer final {
+public:
+  explicit Writer(std::ostream &out) : m_out(out) {
+    m_flags = out.flags();
+    // Timestamps are in microseconds since boot - default precision would
+    // round them.
+    m_precision = out.precision(3);
+    out.setf(std::ios::fixed, std::ios::floatfield);
+  }
+
+  void begin() { m_out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["; }
+
+  void event(unsigned tid, const Event &event) {
+    m_separate();
+    m_out << "{\"name\":\"" << event.name
+          << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":\"cpu\",\"tid\":" << tid
+          << ",\"ts\":" << static_cast<double>(event.begin) * 1e-3
+          << ",\"dur\":"
+          << static_cast<double>(event.end - event.begin) * 1e-3 << "}";
+  }
+
+  void threadName(unsigned tid, const char *name) {
+    m_separate();
+    m_out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":\"cpu\","
+          << "\"tid\":" << tid << ",\"args\":{\"name\":\"" << name << "\"}}";
+  }
+
+  void end() { m_out << "]}"; }
+
+  // Continues list of events written by previous writer.
+  void resume(bool empty) { m_first = empty; }
+
+  bool empty() const { return m_first; }
+
+  ~Writer() {
+    m_out.flags(m_flags);
+    m_out.precision(m_precision);
+  }
+
+private:
+  void m_separate() {
+    if (!m_first)
+      m_out << ',';
+    m_first = false;
+  }
+
+  std::ostream &m_out;
+  std::ios::fmtflags m_flags;
+  std::streamsize m_precision;
+  bool m_first = true;
+};
+
+struct Registry {
+  // Guards list of buffers and reading from them.
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  // Ids of retired threads are not reused.
+  unsigned nextTid = 0u;
+  std::atomic<uint64_t> dropped = 0u;
+
+  std::mutex streamMutex;
+  std::condition_variable streamCv;
+  std::ofstream stream;
+  bool streamEmpty = true;
+  bool streamStop = false;
+  std::thread streamThread;
+};
+
+Registry &registry() {
+  static Registry registry;
+  return registry;
+}
+
+ThreadBuffer &threadBuffer() {
+  // Registry keeps buffer alive after thread exits, so that it's remaining
+  // spans are still drained. Buffer is retired on thread exit and dropped by
+  // the next drain.
+  struct Owner {
+    Owner() : buffer(std::make_shared<ThreadBuffer>()) {
+      auto &registry = ::imvk::trace::registry();
+      auto lock = std::unique_lock{registry.mutex};
+      buffer->tid = registry.nextTid++;
+      registry.buffers.push_back(buffer);
+    }
+    ~Owner() { buffer->retired.store(true, std::memory_order_release); }
+    std::shared_ptr<ThreadBuffer> buffer;
+  };
+  thread_local Owner owner;
+  return *owner.buffer;
+}
+
+// Must be called with registry lock held.
+void drain(Registry &registry, Writer &writer) {
+  std::erase_if(registry.buffers, [&](auto &buffer) {
+    // Loaded before head, so that spans recorded before retirement are seen.
+    auto retired = buffer->retired.load(std::memory_order_acquire);
+    auto head = buffer->head.load(std::memory_order_acquire);
+    auto tail = buffer->tail.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail)
+      writer.event(buffer->tid, buffer->events[tail % ringCapacity]);
+    buffer->tail.store(tail, std::memory_order_release);
+    if (!retired)
+      return false;
+    // Name would be written at the end of trace, buffer is gone by then.
+    if (auto *name = buffer->name.load(std::memory_order_relaxed))
+      writer.threadName(buffer->tid, name);
+    return true;
+  });
+}
+
+// Must be called with registry lock held.
+void writeThreadNames(Registry &registry, Writer &writer) {
+  for (auto &buffer : registry.buffers)
+    if (auto *name = buffer->name.load(std::memory_order_relaxed))
+      writer.threadName(buffer->tid, name);
+}
+
+} // namespace
+
+void record(const char *name, uint64_t begin, uint64_t end) {
+  auto &buffer = threadBuffer();
+  auto head = buffer.head.load(std::memory_order_relaxed);
+  if (head - buffer.tail.load(std::memory_order_acquire) == ringCapacity) {
+    registry().dropped.fetch_add(1u, std::memory_order_relaxed);
+    return;
+  }
+  buffer.events[head % ringCapacity] = Event{name, begin, end};
+  buffer.head.store(head + 1u, std::memory_order_release);
+}
+
+void setThreadName(const char *name) {
+  threadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+void dump(std::ostream &out) {
+  auto &registry = ::imvk::trace::registry();
+  auto lock = std::unique_lock{registry.mutex};
+  Writer writer{out};
+  writer.begin();
+  drain(registry, writer);
+  writeThreadNames(registry, writer);
+  writer.end();
+}
+
+void startStreaming(const std::filesystem::path &path,
+                    std::chrono::milliseconds period) {
+  auto &registry = ::imvk::trace::registry();
+  auto lock = std::unique_lock{registry.streamMutex};
+  if (registry.streamThread.joinable())
+    throw std::runtime_error("Trace streaming is already started.");
+  registry.stream.open(path, std::ios::binary | std::ios::trunc);
+  if (!registry.stream)
+    throw std::runtime_error("Failed to open trace file " + path.string() +
+                             ".");
+
+  Writer{registry.stream}.begin();
+  registry.streamEmpty = true;
+  registry.streamStop = false;
+  registry.streamThread = std::thread{[&registry, period]() {
+    auto lock = std::unique_lock{registry.streamMutex};
+    while (!registry.streamStop) {
+      registry.streamCv.wait_for(lock, period);
+      auto drainLock = std::unique_lock{registry.mutex};
+      Writer writer{registry.stream};
+      writer.resume(registry.streamEmpty);
+      drain(registry, writer);
+      registry.streamEmpty = writer.empty();
+      registry.stream.flush();
+    }
+  }};
+}
+
+void stopStreaming() {
+  auto &registry = ::imvk::trace::registry();
+  {
+    auto lock = std::unique_lock{registry.streamMutex};
+    if (!registry.streamThread.joinable())
+      return;
+    registry.streamStop = true;
+  }
+  registry.streamCv.notify_one();
+  registry.streamThread.join();
+
+  auto lock = std::unique_lock{registry.mutex};
+  Writer writer{registry.stream};
+  writer.resume(registry.streamEmpty);
+  drain(registry, writer);
+  writeThreadNames(registry, writer);
+  writer.end();
+  registry.stream.close();
+}
+
+uint64_t droppedCount() {
+  return registry().dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace imvk::trace
@@ -0,0 +1,173 @@
+#include "imvk/compute/Engine.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace imvk {
+
+namespace {
+
+constexpr unsigned defaultBatchesInFlight = 4u;
+
+} // namespace
+
+ComputeEngine::Batch::Batch(ComputeEngine &engine)
+    : commands(engine.commandPool()) {}
+
+ComputeEngine::ComputeEngine(ContextImpl &context,
+                             const ComputeEngineCreateInfo &CI)
+    : EngineBase(context, QueueCapsInfo{.present = false,
+                                        .graphics = false,
+                                        .compute = true,
+                                        .transfer = false}) {
+  // Timeline may be reused from a destroyed engine.
+  m_completedValue = lastSyncPoint().value;
+  auto batchCount =
+      CI.maxBatchesInFlight ? CI.maxBatchesInFlight : defaultBatchesInFlight;
+  std::ranges::generate_n(std::back_inserter(m_batches), batchCount,
+                          [this]() { return std::make_unique<Batch>(*this); });
+  std::ranges::transform(m_batches, std::back_inserter(m_freeBatches),
+                         [](auto &&batch) { return batch.get(); });
+
+  m_submitThread = std::thread{[this]() { m_submitLoop(); }};
+  m_completionThread = std::thread{[this]() { m_completionLoop(); }};
+}
+
+ComputeEngine::Submission ComputeEngine::enqueue(RecordJob job,
+                                                 CompletionCallback callback) {
+  auto lock = std::unique_lock{m_mutex};
+  // Points are reserved in enqueue order and are signaled in the same order
+  // by submission thread.
+  auto &pending =
+      m_pending.emplace_back(Job{std::move(job), std::move(callback),
+                                 std::promise<void>{}, nextSyncPoint(),
+                                 SubmitBatch{}});
+  consumeWaits(pending.submitBatch);
+  pending.submitBatch.addSignal(pending.point);
+  auto ret = Submission{pending.promise.get_future().share(), pending.point};
+  lock.unlock();
+  m_submitCv.notify_one();
+  return ret;
+}
+
+uint64_t ComputeEngine::completedValue() const {
+  auto lock = std::unique_lock{m_mutex};
+  return m_completedValue;
+}
+
+void ComputeEngine::m_submitLoop() {
+  std::vector<Batch *> batches;
+
+  auto lock = std::unique_lock{m_mutex};
+  for (;;) {
+    m_submitCv.wait(lock, [this]() {
+      return (!m_pending.empty() && !m_freeBatches.empty()) ||
+             (m_stop && m_pending.empty());
+    });
+    if (m_pending.empty())
+      break;
+
+    // Take every pending job there is a free command buffer for.
+    batches.clear();
+    while (!m_pending.empty() && !m_freeBatches.empty()) {
+      auto *batch = m_freeBatches.back();
+      m_freeBatches.pop_back();
+      batch->job = std::move(m_pending.front());
+      m_pending.pop_front();
+      batches.push_back(batch);
+    }
+    lock.unlock();
+
+    // All batches are handed to the queue at once, so they end up in one
+    // submission. Each of them signals its own sync point so completion is
+    // tracked per batch.
+    for (auto *batch : batches) {
+      auto &submitBatch = batch->job.submitBatch;
+      try {
+        batch->commands.reset(0);
+        batch->commands.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        std::invoke(batch->job.record, batch->commands);
+        batch->commands.end();
+        batch->failed = false;
+        submitBatch.addCommandBuffer(batch->commands);
+      } catch (...) {
+        // Point must be signaled anyway since others may wait on it.
+        batch->job.promise.set_exception(std::current_exception());
+        batch->failed = true;
+      }
+    }
+
+    std::vector<SubmitBatch> submitBatches;
+    std::ranges::transform(
+        batches, std::back_inserter(submitBatches),
+        [](auto *batch) { return std::move(batch->job.submitBatch); });
+    auto submitted = queue().submit(std::move(submitBatches)).share();
+    for (auto *batch : batches)
+      batch->submitted = submitted;
+
+    lock.lock();
+    std::ranges::copy(batches, std::back_inserter(m_inFlight));
+    m_completionCv.notify_one();
+  }
+
+  m_submitDone = true;
+  m_completionCv.notify_one();
+}
+
+void ComputeEngine::m_completionLoop() {
+  auto lock = std::unique_lock{m_mutex};
+  for (;;) {
+    m_completionCv.wait(
+        lock, [this]() { return !m_inFlight.empty() || m_submitDone; });
+    if (m_inFlight.empty())
+      break;
+
+    auto *batch = m_inFlight.front();
+    lock.unlock();
+    // Submission may still be pending in queue's batcher.
+    queue().flushCoalesced();
+    std::exception_ptr error;
+    try {
+      batch->submitted.get();
+      batch->job.point.wait();
+    } catch (...) {
+      // Point is never signaled if submission failed.
+      error = std::current_exception();
+    }
+
+    if (!batch->failed && !error && batch->job.callback) {
+      // Callback is user code - it must not take the engine down.
+      try {
+        std::invoke(batch->job.callback);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    if (!batch->failed) {
+      if (error)
+        batch->job.promise.set_exception(error);
+      else
+        batch->job.promise.set_value();
+    }
+    auto value = batch->job.point.value;
+    batch->job = Job{};
+
+    lock.lock();
+    m_inFlight.pop_front();
+    m_completedValue = value;
+    m_freeBatches.push_back(batch);
+    m_submitCv.notify_one();
+  }
+}
+
+ComputeEngine::~ComputeEngine() {
+  {
+    auto lock = std::unique_lock{m_mutex};
+    m_stop = true;
+  }
+  m_submitCv.notify_one();
+  m_submitThread.join();
+  m_completionThread.join();
+}
+
+} // namespace imvk
@@ -0,0 +1,287 @@
+#include "imvk/copy/Engine.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+namespace imvk {
+
+namespace {
+
+constexpr VkDeviceSize defaultStagingBufferSize = 64u * 1024u * 1024u;
+constexpr unsigned defaultBatchesInFlight = 3u;
+// Satisfies bufferOffset requirements of vkCmdCopyBufferToImage for every
+// texel block size up to 16 bytes.
+constexpr VkDeviceSize stagingAlignment = 16u;
+
+} // namespace
+
+void UploadFuture::then(std::function<void()> continuation) const {
+  {
+    auto lock = std::unique_lock{m_continuations->mutex};
+    if (!m_continuations->done) {
+      m_continuations->list.push_back(std::move(continuation));
+      return;
+    }
+  }
+  std::invoke(continuation);
+}
+
+void UploadFuture::m_runContinuations() const {
+  std::vector<std::function<void()>> list;
+  {
+    auto lock = std::unique_lock{m_continuations->mutex};
+    m_continuations->done = true;
+    list.swap(m_continuations->list);
+  }
+  for (auto &continuation : list)
+    std::invoke(continuation);
+}
+
+CopyEngine::Batch::Batch(CopyEngine &engine)
+    : commands(engine.commandPool()) {}
+
+CopyEngine::CopyEngine(ContextImpl &context, const CopyEngineCreateInfo &CI)
+    : EngineBase(context, QueueCapsInfo{.present = false,
+                                        .graphics = false,
+                                        .compute = false,
+                                        .transfer = true}),
+      m_staging(context.device(),
+                CI.stagingBufferSize ? CI.stagingBufferSize
+                                     : defaultStagingBufferSize,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT) {
+  auto batchCount =
+      CI.maxBatchesInFlight ? CI.maxBatchesInFlight : defaultBatchesInFlight;
+  // One extra batch is being recorded while others are in flight.
+  std::ranges::generate_n(std::back_inserter(m_batches), batchCount + 1u,
+                          [this]() { return std::make_unique<Batch>(*this); });
+  std::ranges::transform(m_batches, std::back_inserter(m_freeBatches),
+                         [](auto &&batch) { return batch.get(); });
+
+  m_completionThread = std::thread{[this]() { m_completionLoop(); }};
+}
+
+UploadFuture CopyEngine::upload(VkBuffer dst, VkDeviceSize dstOffset,
+                                std::span<const std::byte> data) {
+  auto &core = context().device().core<1, 0>();
+  auto lock = std::unique_lock{m_mutex};
+  UploadFuture ret;
+  if (data.empty()) {
+    std::promise<void> ready;
+    ready.set_value();
+    ret = UploadFuture{ready.get_future().share()};
+    ret.m_runContinuations();
+    return ret;
+  }
+  while (!data.empty()) {
+    auto chunk = data.first(std::min<size_t>(data.size(), m_staging.size()));
+    VkDeviceSize offset;
+    auto &batch = m_reserve(lock, chunk.size(), offset);
+    std::memcpy(m_staging.mapped().data() + offset, chunk.data(),
+                chunk.size());
+
+    VkBufferCopy region{};
+    region.srcOffset = offset;
+    region.dstOffset = dstOffset;
+    region.size = chunk.size();
+    core.vkCmdCopyBuffer(batch.commands, m_staging.buffer(), dst, 1, &region);
+    ++batch.copyCount;
+    ret = batch.future;
+
+    dstOffset += chunk.size();
+    data = data.subspan(chunk.size());
+  }
+  m_cv.notify_all();
+  return ret;
+}
+
+UploadFuture CopyEngine::upload(VkImage dst,
+                                const VkImageSubresourceRange &range,
+                                VkImageLayout finalLayout,
+                                std::span<const VkBufferImageCopy> regions,
+                                std::span<const std::byte> data) {
+  if (data.size() > m_staging.size())
+    throw std::runtime_error(
+        "Failed to upload image - data does not fit in staging buffer.");
+
+  auto &core = context().device().core<1, 0>();
+  auto lock = std::unique_lock{m_mutex};
+  VkDeviceSize offset;
+  auto &batch = m_reserve(lock, data.size(), offset);
+  std::memcpy(m_staging.mapped().data() + offset, data.data(), data.size());
+
+  VkImageMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.image = dst;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.subresourceRange = range;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  batch.commands.imageMemoryBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    std::span{&barrier, 1u});
+
+  std::vector<VkBufferImageCopy> stagedRegions{regions.begin(), regions.end()};
+  for (auto &region : stagedRegions)
+    region.bufferOffset += offset;
+  core.vkCmdCopyBufferToImage(batch.commands, m_staging.buffer(), dst,
+                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              stagedRegions.size(), stagedRegions.data());
+
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = finalLayout;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = 0;
+  batch.commands.imageMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                    std::span{&barrier, 1u});
+  ++batch.copyCount;
+
+  m_cv.notify_all();
+  return batch.future;
+}
+
+SyncPoint CopyEngine::flush() {
+  auto lock = std::unique_lock{m_mutex};
+  if (m_recording && m_recording->copyCount)
+    m_submitRecording();
+  return lastSyncPoint();
+}
+
+CopyEngine::Batch &CopyEngine::m_reserve(std::unique_lock<std::mutex> &lock,
+                                         VkDeviceSize size,
+                                         VkDeviceSize &offset) {
+  auto ringSize = m_staging.size();
+  // Ring space and recording batch must be acquired under single lock hold.
+  // Otherwise staged region may be accounted to a batch that is already
+  // submitted.
+  for (;;) {
+    if (!m_recording && m_freeBatches.empty()) {
+      m_cv.wait(lock);
+      continue;
+    }
+
+    // With nothing staged ring positions are rebased, otherwise allocation
+    // that doesn't fit before the end of ring would wait for a wrap that
+    // nobody is going to release.
+    if (!m_recording && m_submitted.empty())
+      m_ringHead = m_ringTail = 0u;
+
+    auto start = (m_ringHead + stagingAlignment - 1u) / stagingAlignment *
+                 stagingAlignment;
+    // Allocation must not wrap around the end of ring.
+    if (start % ringSize + size > ringSize)
+      start = (start / ringSize + 1u) * ringSize;
+    if (start + size - m_ringTail > ringSize) {
+      // Release space held by recording batch once it's complete.
+      if (m_recording && m_recording->copyCount)
+        m_submitRecording();
+      m_cv.wait(lock);
+      continue;
+    }
+
+    if (!m_recording) {
+      m_recording = m_freeBatches.back();
+      m_freeBatches.pop_back();
+      m_recording->promise = std::promise<void>{};
+      m_recording->future =
+          UploadFuture{m_recording->promise.get_future().share()};
+      // Point is reserved right away so that lastSyncPoint() covers uploads
+      // of batch being recorded.
+      m_recording->point = nextSyncPoint();
+      m_recording->ringBegin = start;
+      m_recording->commands.reset(0);
+      m_recording->commands.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    }
+
+    m_ringHead = start + size;
+    offset = start % ringSize;
+    return *m_recording;
+  }
+}
+
+void CopyEngine::m_submitRecording() {
+  auto *batch = std::exchange(m_recording, nullptr);
+  batch->commands.end();
+  batch->ringEnd = m_ringHead;
+
+  auto ringSize = m_staging.size();
+  auto begin = batch->ringBegin % ringSize;
+  auto length = batch->ringEnd - batch->ringBegin;
+  if (begin + length > ringSize) {
+    m_staging.flush(begin, ringSize - begin);
+    m_staging.flush(0, begin + length - ringSize);
+  } else
+    m_staging.flush(begin, length);
+
+  SubmitBatch submitBatch;
+  submitBatch.addCommandBuffer(batch->commands);
+  submitBatch.addSignal(batch->point);
+  consumeWaits(submitBatch);
+  batch->submitted = queue().submit(std::move(submitBatch));
+  m_submitted.push_back(batch);
+  m_cv.notify_all();
+}
+
+void CopyEngine::m_completionLoop() {
+  auto lock = std::unique_lock{m_mutex};
+  for (;;) {
+    if (m_submitted.empty()) {
+      // Device is idle - submit whatever was recorded so far. Uploads that
+      // arrive while this batch is executing will form the next one.
+      if (m_recording && m_recording->copyCount) {
+        m_submitRecording();
+        continue;
+      }
+      if (m_stop)
+        return;
+      m_cv.wait(lock);
+      continue;
+    }
+
+    auto *batch = m_submitted.front();
+    lock.unlock();
+    // Submission may still be pending in queue's batcher.
+    queue().flushCoalesced();
+    std::exception_ptr error;
+    try {
+      batch->submitted.get();
+      batch->point.wait();
+    } catch (...) {
+      // Point is never signaled if submission failed.
+      error = std::current_exception();
+    }
+    lock.lock();
+
+    m_submitted.pop_front();
+    batch->copyCount = 0;
+    m_ringTail = batch->ringEnd;
+    if (error)
+      batch->promise.set_exception(error);
+    else
+      batch->promise.set_value();
+    auto future = batch->future;
+    m_freeBatches.push_back(batch);
+    m_cv.notify_all();
+
+    // Continuations are free to schedule more uploads.
+    lock.unlock();
+    future.m_runContinuations();
+    lock.lock();
+  }
+}
+
+CopyEngine::~CopyEngine() {
+  {
+    auto lock = std::unique_lock{m_mutex};
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_completionThread.join();
+}
+
+} // namespace imvk
@@ -0,0 +1,83 @@
+#include "imvk/copy/ResourceAllocators.hpp"
+
+namespace imvk {
+
+namespace {
+
+VkImageAspectFlags aspectOf(VkFormat format) {
+  switch (format) {
+  case VK_FORMAT_D16_UNORM:
+  case VK_FORMAT_X8_D24_UNORM_PACK32:
+  case VK_FORMAT_D32_SFLOAT:
+    return VK_IMAGE_ASPECT_DEPTH_BIT;
+  case VK_FORMAT_S8_UINT:
+    return VK_IMAGE_ASPECT_STENCIL_BIT;
+  case VK_FORMAT_D16_UNORM_S8_UINT:
+  case VK_FORMAT_D24_UNORM_S8_UINT:
+  case VK_FORMAT_D32_SFLOAT_S8_UINT:
+    return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+  default:
+    return VK_IMAGE_ASPECT_COLOR_BIT;
+  }
+}
+
+} // namespace
+
+BufferUploadAllocator::BufferUploadAllocator(CopyEngine &copyEngine,
+                                             const VkBufferCreateInfo &CI)
+    : m_copyEngine(copyEngine), m_CI(CI),
+      m_queueFamilies(CI.pQueueFamilyIndices,
+                      CI.pQueueFamilyIndices + CI.queueFamilyIndexCount) {
+  m_CI.pNext = nullptr;
+  m_CI.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  m_CI.pQueueFamilyIndices = m_queueFamilies.data();
+}
+
+BufferUploadAllocator::BufferUploadAllocator(
+    const BufferUploadAllocator &another)
+    : BufferUploadAllocator(another.m_copyEngine, another.m_CI) {}
+
+std::pair<std::shared_ptr<PrimitiveHandleImpl<Buffer>>, UploadFuture>
+BufferUploadAllocator::allocate(FramedEngine &engine,
+                                std::span<const std::byte> data) const {
+  auto CI = m_CI;
+  CI.size = data.size();
+  auto buffer = std::make_shared<PrimitiveHandleImpl<Buffer>>(
+      engine, engine.context().deviceAllocator(), CI, MemoryUsage::device);
+  auto uploaded = m_copyEngine.upload(buffer->handle(), 0u, data);
+  return {std::move(buffer), std::move(uploaded)};
+}
+
+ImageUploadAllocator::ImageUploadAllocator(CopyEngine &copyEngine,
+                                           const VkImageCreateInfo &CI,
+                                           VkImageLayout finalLayout)
+    : m_copyEngine(copyEngine), m_CI(CI),
+      m_queueFamilies(CI.pQueueFamilyIndices,
+                      CI.pQueueFamilyIndices + CI.queueFamilyIndexCount),
+      m_finalLayout(finalLayout) {
+  m_CI.pNext = nullptr;
+  m_CI.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  m_CI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  m_CI.pQueueFamilyIndices = m_queueFamilies.data();
+}
+
+ImageUploadAllocator::ImageUploadAllocator(const ImageUploadAllocator &another)
+    : ImageUploadAllocator(another.m_copyEngine, another.m_CI,
+                           another.m_finalLayout) {}
+
+std::pair<std::shared_ptr<PrimitiveHandleImpl<Image>>, UploadFuture>
+ImageUploadAllocator::allocate(FramedEngine &engine,
+                               std::span<const VkBufferImageCopy> regions,
+                               std::span<const std::byte> data) const {
+  auto image = std::make_shared<PrimitiveHandleImpl<Image>>(
+      engine, engine.context().deviceAllocator(), m_CI, MemoryUsage::device);
+  VkImageSubresourceRange range{};
+  range.aspectMask = aspectOf(m_CI.format);
+  range.levelCount = m_CI.mipLevels;
+  range.layerCount = m_CI.arrayLayers;
+  auto uploaded =
+      m_copyEngine.upload(image->handle(), range, m_finalLayout, regions, data);
+  return {std::move(image), std::move(uploaded)};
+}
+
+} // namespace imvk
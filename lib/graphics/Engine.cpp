@@ -1,4 +1,5 @@
 #include "imvk/graphics/Engine.hpp"
+#include "imvk/base/Trace.hpp"
 #include "imvk/graphics/Frame.hpp"
 #include "imvk/graphics/Swapchain.hpp"
 
@@ -6,19 +7,40 @@
 
 namespace imvk {
 
+namespace {
+
+constexpr VkExtent2D defaultOffscreenExtent{1920u, 1080u};
+constexpr VkFormat defaultOffscreenFormat = VK_FORMAT_B8G8R8A8_UNORM;
+
+} // namespace
+
 GraphicsEngine::GraphicsEngine(ContextImpl &context,
                                const GraphicsEngineCreateInfo &CI)
     : FramedEngine(context,
-                   QueueCapsInfo{.present = true,
+                   QueueCapsInfo{.present = CI.swapchainFactory != nullptr,
                                  .graphics = true,
                                  .compute = true,
                                  .transfer = true},
-                   CI.maxFramesInFlight),
-      m_swapchainFactory(*CI.swapchainFactory),
-      m_swapchain(std::make_unique<Swapchain>(
-          context.device(), queue(),
-          m_swapchainFactory.getCreateInfo(context.device()))) {
+                   CI.maxFramesInFlight, CI.transientBufferSize,
+                   CI.gpuScopesPerFrame),
+      m_swapchainFactory(CI.swapchainFactory),
+      m_pacer(CI.pacingMode, getFIFCount(), CI.maxFrameRate) {
   assert(CI.maxFramesInFlight);
+  if (m_swapchainFactory)
+    m_swapchain = std::make_unique<Swapchain>(
+        context.device(), m_swapchainFactory->getCreateInfo(context.device()));
+  else {
+    auto extent = CI.offscreenExtent;
+    if (!extent.width || !extent.height)
+      extent = defaultOffscreenExtent;
+    // Frames in flight never exceed ring size, so image is reused only once
+    // device is done with frame that used it before.
+    m_swapchain = std::make_unique<OffscreenSwapchain>(
+        context.deviceAllocator(), getFIFCount(),
+        CI.offscreenFormat != VK_FORMAT_UNDEFINED ? CI.offscreenFormat
+                                                  : defaultOffscreenFormat,
+        extent);
+  }
   m_frameSyncs.reserve(getFIFCount());
 
   std::ranges::transform(std::ranges::iota_view{0u, getFIFCount()},
@@ -27,51 +49,111 @@ GraphicsEngine::GraphicsEngine(ContextImpl &context,
 }
 
 std::optional<SwapFrame> GraphicsEngine::m_beginFrame() {
+  IMVK_TRACE_SCOPE("GraphicsEngine::beginFrame");
   assert(!m_currentFrame);
+  if (m_pacer.framesInFlight() != getDynamicFIFCount())
+    setDynamicFIFCount(m_pacer.framesInFlight());
   auto &frameSync = m_frameSyncs.at(getCurrentFrameId());
-  frameSync.waitIfNeeded();
+  m_pacer.fenceWaited(frameSync.waitIfNeeded());
+  m_collectGarbage();
 
-  auto status = m_swapchain->acquireNextImage(
-      frameSync.presentComplete, /* timeout in milliseconds*/ 1000);
+  if (headless()) {
+    static_cast<OffscreenSwapchain &>(*m_swapchain).acquireNextImage();
+    return m_beginAndGetCurrentFrame();
+  }
+
+  if (m_recreatePending && !m_surface_minimized()) {
+    m_recreate_swapchain();
+    m_recreatePending = false;
+  }
+
+  auto status = [&]() {
+    IMVK_TRACE_SCOPE("Swapchain::acquireNextImage");
+    return static_cast<Swapchain &>(*m_swapchain)
+        .acquireNextImage(frameSync.presentComplete,
+                          /* timeout in milliseconds*/ 1000);
+  }();
   if (status == vkw::SwapChain::AcquireStatus::TIMEOUT)
     return std::nullopt;
-  if (status == vkw::SwapChain::AcquireStatus::OUT_OF_DATE ||
-      status == vkw::SwapChain::AcquireStatus::SUBOPTIMAL) {
+  if (status == vkw::SwapChain::AcquireStatus::OUT_OF_DATE) {
+    // No image is acquired, so swapchain may be replaced right away.
     if (!m_surface_minimized())
       m_recreate_swapchain();
     return std::nullopt;
   }
+  // Suboptimal image is still acquired and it's semaphore will be signaled,
+  // so frame is rendered as usual and swapchain is replaced before next one.
+  if (status == vkw::SwapChain::AcquireStatus::SUBOPTIMAL)
+    m_recreatePending = true;
+
+  return m_beginAndGetCurrentFrame();
+}
 
-  m_currentFrame = SwapFrame{beginAndGetCurrentFrame(), *m_swapchain};
+SwapFrame GraphicsEngine::m_beginAndGetCurrentFrame() {
+  m_pacer.recordStarted();
+  auto &frame = beginAndGetCurrentFrame();
+  auto &states = frame.resourceStates();
+  m_swapchain->trackCurrentImage(states);
+  // Render passes access current image without going through the tracker,
+  // so it's initial transition is recorded right away.
+  states.flush();
+  m_currentFrame = SwapFrame{frame, *m_swapchain};
   return *m_currentFrame;
 }
 
 void GraphicsEngine::m_endFrame() {
+  IMVK_TRACE_SCOPE("GraphicsEngine::endFrame");
   assert(m_currentFrame);
   auto &frameSync = m_frameSyncs.at(getCurrentFrameId());
+  // Returns current image to layout() if frame moved it out of it with the
+  // tracker. Nothing later in the frame accesses the image, so transition
+  // is waited for by signal of the submission only.
+  m_currentFrame->frame().resourceStates().require(
+      m_swapchain->image(m_swapchain->currentImage()),
+      ResourceAccess{VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0u,
+                     m_swapchain->layout()});
   endAndAdvanceFrame();
-  vkw::SubmitInfo submitInfo{
-      m_currentFrame->frame().commands(), frameSync.presentComplete,
-      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, frameSync.renderComplete};
-  auto presentInfo = vkw::PresentInfo{*m_swapchain, frameSync.renderComplete};
-  auto q = queue().acquire();
-  q.get().submit(submitInfo, frameSync.fence);
-  q.get().present(presentInfo);
+  SubmitBatch submitBatch;
+  submitBatch.addCommandBuffer(m_currentFrame->frame().commands())
+      .addSignal(nextSyncPoint());
+  if (!headless())
+    submitBatch
+        .addWait(frameSync.presentComplete,
+                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT)
+        .addSignal(frameSync.renderComplete);
+  // Extra wait points requested with waitFor() during this frame.
+  consumeWaits(submitBatch);
+  frameSync.submission =
+      queue().submit(std::move(submitBatch), frameSync.fence);
+  if (!headless()) {
+    // Present info captures currently acquired image, so it must be created
+    // right away even if job is executed later.
+    auto presentInfo = std::make_shared<vkw::PresentInfo>(
+        static_cast<Swapchain &>(*m_swapchain), frameSync.renderComplete);
+    frameSync.presentation = queue().execute(
+        [presentInfo = std::move(presentInfo)](vkw::Queue &q) {
+          q.present(*presentInfo);
+        });
+  }
   frameSync.needFenceWait = true;
   m_currentFrame.reset();
+  m_pacer.presented();
 }
 
 void GraphicsEngine::m_recreate_swapchain() {
-  queue().acquire().get().waitIdle();
+  IMVK_TRACE_SCOPE("GraphicsEngine::recreateSwapchain");
+  // No device wait here - frames in flight keep using retired swapchain and
+  // resources released by callbacks through deferDestruction().
   for (auto &&callback :
        m_swapChainCallbacks |
            std::views::transform(
                [](auto &&pair) -> decltype(auto) { return pair.first; }))
     std::invoke(callback);
-  m_swapchain.reset();
+  auto retired = std::move(m_swapchain);
   m_swapchain = std::make_unique<Swapchain>(
-      context().device(), queue(),
-      m_swapchainFactory.getCreateInfo(context().device()));
+      context().device(), m_swapchainFactory->getCreateInfo(context().device()),
+      static_cast<Swapchain &>(*retired));
+  deferDestruction(std::move(retired));
   for (auto &&callback :
        m_swapChainCallbacks |
            std::views::transform(
@@ -81,13 +163,31 @@ void GraphicsEngine::m_recreate_swapchain() {
 
 bool GraphicsEngine::m_surface_minimized() {
   auto extents =
-      m_swapchainFactory.getSurface()
+      m_swapchainFactory->getSurface()
           .getSurfaceCapabilities(context().device().physicalDevice())
           .currentExtent;
   return extents.width == 0 || extents.height == 0;
 }
 
+void GraphicsEngine::m_deferDestruction(std::shared_ptr<void> object) {
+  auto point = lastSyncPoint();
+  // Current frame will signal next point once submitted.
+  if (m_currentFrame)
+    ++point.value;
+  m_deferred.emplace_back(point, std::move(object));
+}
+
+void GraphicsEngine::m_collectGarbage() {
+  IMVK_TRACE_SCOPE("GraphicsEngine::collectGarbage");
+  // Points are appended in increasing order.
+  while (!m_deferred.empty() && m_deferred.front().first.reached())
+    m_deferred.pop_front();
+}
+
 GraphicsEngine::~GraphicsEngine() = default;
 
-void GraphicsEngine::m_terminate() { queue().acquire().get().waitIdle(); }
+void GraphicsEngine::m_terminate() {
+  queue().acquire().get().waitIdle();
+  m_deferred.clear();
+}
 } // namespace imvk
\ No newline at end of file
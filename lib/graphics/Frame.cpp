@@ -1,5 +1,9 @@
 #include "imvk/graphics/Frame.hpp"
+#include "imvk/base/Trace.hpp"
 #include "imvk/graphics/Engine.hpp"
+
+#include <exception>
+
 namespace imvk {
 
 FrameSyncObjects::FrameSyncObjects(GraphicsEngine &engine)
@@ -7,11 +11,37 @@ FrameSyncObjects::FrameSyncObjects(GraphicsEngine &engine)
       presentComplete(engine.context().device()),
       fence(engine.context().device()) {}
 
-void FrameSyncObjects::waitIfNeeded() {
+std::chrono::steady_clock::duration FrameSyncObjects::waitIfNeeded() {
+  IMVK_TRACE_SCOPE("FrameSyncObjects::waitIfNeeded");
+  auto start = std::chrono::steady_clock::now();
   if (needFenceWait) {
-    fence.wait();
-    fence.reset();
+    // Frame is consumed even if it failed, so next call does not wait on a
+    // fence nothing is going to signal.
     needFenceWait = false;
+    std::exception_ptr error;
+    bool submitted = true;
+    try {
+      if (submission.valid())
+        submission.get();
+    } catch (...) {
+      error = std::current_exception();
+      submitted = false;
+    }
+    try {
+      if (presentation.valid())
+        presentation.get();
+    } catch (...) {
+      if (!error)
+        error = std::current_exception();
+    }
+    // Fence is signaled only by successful submission.
+    if (submitted) {
+      fence.wait();
+      fence.reset();
+    }
+    if (error)
+      std::rethrow_exception(error);
   }
+  return std::chrono::steady_clock::now() - start;
 }
 } // namespace imvk
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "imvk/graphics/FramePacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace imvk {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Weight of the newest sample in smoothed timings is 1 / smoothingFactor.
+constexpr int smoothingFactor = 8;
+// Fence wait latency mode aims for. Keeps host slightly ahead of device so
+// that device is not starved by sleep overshoot.
+constexpr auto fenceWaitMargin = 500us;
+// Fraction of fence wait error applied to sleep time each frame.
+constexpr int controllerGain = 4;
+// Present interval this much larger than smoothed one is treated as a spike.
+constexpr double spikeRatio = 1.5;
+// Frames without spikes before frames in flight are lowered again.
+constexpr unsigned stableFramesToShrink = 120u;
+// Sleeping is coarse on most systems - the rest is spun.
+constexpr auto spinThreshold = 1ms;
+
+void smooth(FramePacer::Clock::duration &value,
+            FramePacer::Clock::duration sample) {
+  value += (sample - value) / smoothingFactor;
+}
+
+void sleepUntil(FramePacer::Clock::time_point deadline) {
+  if (deadline - FramePacer::Clock::now() > spinThreshold)
+    std::this_thread::sleep_until(deadline - spinThreshold);
+  while (FramePacer::Clock::now() < deadline)
+    std::this_thread::yield();
+}
+
+unsigned minFramesInFlight(FramePacingMode mode, unsigned maxFramesInFlight) {
+  // Single frame in flight serializes host and device completely.
+  return mode == FramePacingMode::latency ? std::min(2u, maxFramesInFlight)
+                                          : maxFramesInFlight;
+}
+
+} // namespace
+
+FramePacer::FramePacer(FramePacingMode mode, unsigned maxFramesInFlight,
+                       float maxFrameRate)
+    : m_mode(mode), m_maxFramesInFlight(maxFramesInFlight),
+      m_limiterPeriod(maxFrameRate > 0.0f
+                          ? std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(1.0 /
+                                                              maxFrameRate))
+                          : Clock::duration::zero()),
+      m_framesInFlight(minFramesInFlight(mode, maxFramesInFlight)) {}
+
+void FramePacer::sleep() {
+  auto wakeUp = Clock::now() + m_sleepTime;
+  if (m_limiterPeriod != Clock::duration::zero()) {
+    wakeUp = std::max(wakeUp, m_nextFrame);
+    // Deadlines advance by whole periods so that frame rate does not drift.
+    // Frame that started late shortens the next period, but longer stalls
+    // are not caught up with bursts of frames.
+    m_nextFrame = std::max(m_nextFrame + m_limiterPeriod, wakeUp);
+  }
+  sleepUntil(wakeUp);
+}
+
+void FramePacer::fenceWaited(Clock::duration duration) {
+  smooth(m_fenceWaitTime, duration);
+  m_lastFenceWait = duration;
+  if (m_mode != FramePacingMode::latency)
+    return;
+
+  // Time host is blocked on fence is moved to sleep before the frame.
+  m_sleepTime += (duration - fenceWaitMargin) / controllerGain;
+  m_sleepTime = std::clamp(m_sleepTime, Clock::duration::zero(),
+                           std::max(m_presentInterval - m_recordTime,
+                                    Clock::duration::zero()));
+}
+
+void FramePacer::presented() {
+  auto now = Clock::now();
+  smooth(m_recordTime, now - m_recordStart);
+  if (m_lastPresent != Clock::time_point{}) {
+    auto interval = now - m_lastPresent;
+    m_adaptFramesInFlight(interval);
+    smooth(m_presentInterval, interval);
+  }
+  m_lastPresent = now;
+}
+
+void FramePacer::m_adaptFramesInFlight(Clock::duration interval) {
+  if (m_mode != FramePacingMode::latency)
+    return;
+
+  // Spike while host was not waiting for device means device ran out of
+  // work - sleep overshot or device load varies more than frames in flight
+  // can absorb.
+  auto spike = m_presentInterval != Clock::duration::zero() &&
+               interval > m_presentInterval * spikeRatio &&
+               m_lastFenceWait < fenceWaitMargin;
+  if (spike) {
+    m_stableFrames = 0u;
+    m_sleepTime /= 2;
+    if (m_framesInFlight < m_maxFramesInFlight)
+      ++m_framesInFlight;
+    return;
+  }
+
+  if (++m_stableFrames < stableFramesToShrink)
+    return;
+  m_stableFrames = 0u;
+  if (m_framesInFlight > minFramesInFlight(m_mode, m_maxFramesInFlight))
+    --m_framesInFlight;
+}
+
+FramePacingStatistics FramePacer::statistics() const {
+  using std::chrono::nanoseconds;
+  return {std::chrono::duration_cast<nanoseconds>(m_recordTime),
+          std::chrono::duration_cast<nanoseconds>(m_fenceWaitTime),
+          std::chrono::duration_cast<nanoseconds>(m_lastFenceWait),
+          std::chrono::duration_cast<nanoseconds>(m_presentInterval),
+          std::chrono::duration_cast<nanoseconds>(m_sleepTime),
+          m_framesInFlight};
+}
+
+} // namespace imvk
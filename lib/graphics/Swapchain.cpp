@@ -1,62 +1,33 @@
 #include "imvk/graphics/Swapchain.hpp"
 
-#include "vkw/Fence.hpp"
+#include <algorithm>
+#include <stdexcept>
 
 namespace imvk {
 
-Swapchain::Swapchain(vkw::Device &device, Queue &q,
-                     const VkSwapchainCreateInfoKHR &CI)
+Swapchain::Swapchain(vkw::Device &device, const VkSwapchainCreateInfoKHR &CI,
+                     VkSwapchainKHR oldSwapchain)
     : vkw::SwapChain(device, [&]() {
         auto CICopy = CI;
         CICopy.pNext = nullptr;
         CICopy.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
         CICopy.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-        CICopy.oldSwapchain = nullptr;
+        // Lets presentation engine reuse resources of the old swapchain and
+        // keep presenting it's images while the new one is being created.
+        CICopy.oldSwapchain = oldSwapchain;
         CICopy.pQueueFamilyIndices = nullptr;
         // TODO: amend info based on needs.
         CICopy.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
         return CICopy;
       }()) {
-  std::vector<VkImageMemoryBarrier> transitLayouts;
+  // Images are transitioned out of UNDEFINED layout by the first frame that
+  // acquires them, so creation never waits for device.
+  m_resetInitialTransitions(images().size());
 
-  for (auto &image : images()) {
-    VkImageMemoryBarrier transitLayout{};
-    transitLayout.image = image.vkw::NonOwingImage::operator VkImage_T *();
-    transitLayout.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    transitLayout.pNext = nullptr;
-    transitLayout.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    transitLayout.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-    transitLayout.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    transitLayout.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    transitLayout.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    transitLayout.subresourceRange.baseArrayLayer = 0;
-    transitLayout.subresourceRange.baseMipLevel = 0;
-    transitLayout.subresourceRange.layerCount = 1;
-    transitLayout.subresourceRange.levelCount = 1;
-    transitLayout.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-    transitLayout.srcAccessMask = 0;
-
-    transitLayouts.push_back(transitLayout);
-  }
-
-  auto queue = q.acquire();
-  auto commandPool = vkw::CommandPool{device, 0, queue.get().family().index()};
-  auto commandBuffer = vkw::PrimaryCommandBuffer{commandPool};
-
-  commandBuffer.begin(0);
-
-  commandBuffer.imageMemoryBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                                   transitLayouts);
-
-  commandBuffer.end();
-
-  auto fence = vkw::Fence{device};
-
-  auto submitInfo = vkw::SubmitInfo(commandBuffer);
-
-  queue.get().submit(submitInfo, fence);
-  fence.wait();
+  auto &firstImage = images().front();
+  m_format = firstImage.format();
+  m_extent = VkExtent2D{firstImage.rawExtents().width,
+                        firstImage.rawExtents().height};
 
   VkComponentMapping mapping;
   mapping.r = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -68,5 +39,88 @@ Swapchain::Swapchain(vkw::Device &device, Queue &q,
     m_image_views.emplace_back(device, image, image.format(), 0u, 1u, 0u, 1u,
                                mapping);
   }
+  std::ranges::transform(m_image_views, std::back_inserter(m_attachments),
+                         [](auto &&view) -> VkImageView { return view; });
+}
+
+VkImage Swapchain::image(uint32_t index) const {
+  return images()[index].vkw::NonOwingImage::operator VkImage_T *();
+}
+
+OffscreenSwapchain::OffscreenSwapchain(DeviceAllocator &allocator,
+                                       unsigned imageCount, VkFormat format,
+                                       VkExtent2D extent,
+                                       VkImageUsageFlags usage)
+    : m_device(allocator.device()), m_format(format), m_extent(extent) {
+  VkImageCreateInfo imageCI{};
+  imageCI.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageCI.imageType = VK_IMAGE_TYPE_2D;
+  imageCI.format = format;
+  imageCI.extent = VkExtent3D{extent.width, extent.height, 1u};
+  imageCI.mipLevels = 1u;
+  imageCI.arrayLayers = 1u;
+  imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageCI.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | usage;
+  imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  VkImageViewCreateInfo viewCI{};
+  viewCI.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+  viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+  viewCI.format = format;
+  viewCI.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+  viewCI.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+  viewCI.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+  viewCI.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+  viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  viewCI.subresourceRange.levelCount = 1u;
+  viewCI.subresourceRange.layerCount = 1u;
+
+  auto &core = m_device.core<1, 0>();
+  try {
+    for (unsigned i = 0; i < imageCount; ++i) {
+      auto &image = m_images.emplace_back(
+          std::make_unique<Image>(allocator, imageCI));
+      viewCI.image = image->handle();
+      VkImageView view;
+      if (core.vkCreateImageView(m_device, &viewCI, nullptr, &view) !=
+          VK_SUCCESS)
+        throw std::runtime_error("Failed to create offscreen image view.");
+      m_attachments.push_back(view);
+    }
+  } catch (...) {
+    for (auto view : m_attachments)
+      core.vkDestroyImageView(m_device, view, nullptr);
+    throw;
+  }
+  m_resetInitialTransitions(imageCount);
+}
+
+OffscreenSwapchain::~OffscreenSwapchain() {
+  for (auto view : m_attachments)
+    m_device.core<1, 0>().vkDestroyImageView(m_device, view, nullptr);
+}
+
+void SwapchainBase::trackCurrentImage(ResourceStateTracker &states) {
+  auto index = currentImage();
+  // Frames wait for acquire semaphore of presentable image at color
+  // attachment output stage, so no access may start earlier than that.
+  auto initial = ResourceAccess{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                0u, layout()};
+  if (!m_needsInitialTransition.at(index)) {
+    states.track(image(index), initial);
+    return;
+  }
+
+  initial.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  states.track(image(index), initial);
+  states.require(image(index),
+                 ResourceAccess{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                                layout()});
+  m_needsInitialTransition.at(index) = false;
 }
-} // namespace imvk
\ No newline at end of file
+
+} // namespace imvk
@@ -0,0 +1,127 @@
+// Packs a directory of compiled SPIR-V shaders into a single file that is
+// consumed by imvk::ShaderPack.
+//
+// Usage: imvk_shader_pack <shader directory> <output file>
+//
+// Every '*.spv' file found recursively in shader directory is stored under
+// the name of it's path relative to that directory, with '/' as separator
+// and without extension: 'post/blur.frag.spv' becomes 'post/blur.frag'.
+
+#include "imvk/base/ShaderPackFormat.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+namespace sp = imvk::shader_pack;
+
+namespace {
+
+struct Shader {
+  std::string name;
+  fs::path path;
+  uint64_t size;
+};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1u) / alignment * alignment;
+}
+
+std::vector<Shader> collect(const fs::path &directory) {
+  std::vector<Shader> ret;
+  for (auto &&entry : fs::recursive_directory_iterator(directory)) {
+    if (!entry.is_regular_file() || entry.path().extension() != ".spv")
+      continue;
+    auto relative = fs::relative(entry.path(), directory);
+    relative.replace_extension();
+    auto size = entry.file_size();
+    if (size % 4u)
+      throw std::runtime_error("file size is not multiple of 4 bytes: " +
+                               entry.path().string());
+    ret.push_back({relative.generic_string(), entry.path(), size});
+  }
+  return ret;
+}
+
+void write(const fs::path &output, std::vector<Shader> shaders) {
+  std::ranges::sort(shaders, [](auto &&lhs, auto &&rhs) {
+    auto lhsHash = sp::hashName(lhs.name);
+    auto rhsHash = sp::hashName(rhs.name);
+    return lhsHash != rhsHash ? lhsHash < rhsHash : lhs.name < rhs.name;
+  });
+
+  sp::Header header{};
+  std::memcpy(header.magic, sp::magic, sizeof(header.magic));
+  header.version = sp::version;
+  header.entryCount = static_cast<uint32_t>(shaders.size());
+  header.indexOffset = sizeof(sp::Header);
+  header.stringsOffset =
+      header.indexOffset + shaders.size() * sizeof(sp::Entry);
+
+  std::vector<sp::Entry> index;
+  std::string strings;
+  for (auto &&shader : shaders) {
+    auto &entry = index.emplace_back();
+    entry.nameHash = sp::hashName(shader.name);
+    entry.nameOffset = static_cast<uint32_t>(strings.size());
+    entry.nameSize = static_cast<uint32_t>(shader.name.size());
+    entry.codeSize = shader.size;
+    strings += shader.name;
+  }
+  header.stringsSize = strings.size();
+
+  auto codeOffset = alignUp(header.stringsOffset + header.stringsSize, 4u);
+  for (auto &entry : index) {
+    entry.codeOffset = codeOffset;
+    codeOffset += entry.codeSize;
+  }
+
+  auto tmpPath = output;
+  tmpPath += ".tmp";
+  {
+    std::ofstream os{tmpPath, std::ios::binary | std::ios::trunc};
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char *>(index.data()),
+             index.size() * sizeof(sp::Entry));
+    os.write(strings.data(), strings.size());
+    auto padding = alignUp(strings.size(), 4u) - strings.size();
+    os.write("\0\0\0", padding);
+
+    std::vector<char> code;
+    for (auto &&shader : shaders) {
+      code.resize(shader.size);
+      std::ifstream is{shader.path, std::ios::binary};
+      if (!is.read(code.data(), code.size()))
+        throw std::runtime_error("failed to read " + shader.path.string());
+      os.write(code.data(), code.size());
+    }
+    os.flush();
+    if (!os)
+      throw std::runtime_error("failed to write " + tmpPath.string());
+  }
+  fs::rename(tmpPath, output);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <shader directory> <output file>\n";
+    return 1;
+  }
+
+  try {
+    auto shaders = collect(argv[1]);
+    write(argv[2], std::move(shaders));
+  } catch (std::exception &e) {
+    std::cerr << "Failed to create shader pack: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}